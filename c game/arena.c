@@ -0,0 +1,59 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define ARENA_ALIGN 64
+
+void InitArena(Arena *arena, size_t blockSize) {
+    memset(arena, 0, sizeof(*arena));
+    arena->blockSize = blockSize;
+}
+
+void UnloadArena(Arena *arena) {
+    ArenaBlock *block = arena->head;
+    while (block != NULL) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    InitArena(arena, arena->blockSize);
+}
+
+static size_t AlignUp(size_t v) {
+    return (v + (ARENA_ALIGN - 1)) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+void *ArenaAlloc(Arena *arena, size_t size) {
+    size = AlignUp(size);
+
+    ArenaBlock *block = arena->head;
+    uintptr_t base = 0;
+    size_t offset = 0;
+    if (block != NULL) {
+        base = (uintptr_t)(block + 1);
+        offset = AlignUp(base + block->used) - base;
+    }
+
+    if (block == NULL || offset + size > block->size) {
+        // Oversized requests get a block of their own; the slack covers alignment
+        size_t dataSize = (size > arena->blockSize) ? size : arena->blockSize;
+        block = malloc(sizeof(ArenaBlock) + dataSize + ARENA_ALIGN);
+        if (block == NULL) return NULL;
+        block->next = arena->head;
+        block->size = dataSize + ARENA_ALIGN;
+        block->used = 0;
+        arena->head = block;
+        arena->reserved += block->size;
+        arena->blockCount++;
+
+        base = (uintptr_t)(block + 1);
+        offset = AlignUp(base) - base;
+    }
+
+    void *ptr = (void *)(base + offset);
+    block->used = offset + size;
+    arena->used += size;
+    memset(ptr, 0, size);
+    return ptr;
+}
@@ -0,0 +1,29 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Bump allocator over a list of large blocks. Nothing is freed individually: memory handed
+// out stays at the same address until UnloadArena(), which is what lets entity chunks grow
+// without moving anything already allocated.
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;
+    size_t used;
+} ArenaBlock;
+
+typedef struct {
+    ArenaBlock *head;       // Block currently being bumped
+    size_t blockSize;       // Default size of new blocks
+    size_t reserved;        // Bytes obtained from the system
+    size_t used;            // Bytes handed out
+    int blockCount;
+} Arena;
+
+void InitArena(Arena *arena, size_t blockSize);
+void UnloadArena(Arena *arena);
+
+// Zeroed memory aligned to 64 bytes (a cache line, enough for any SIMD load)
+void *ArenaAlloc(Arena *arena, size_t size);
+
+#endif // ARENA_H
@@ -0,0 +1,145 @@
+#include "assets.h"
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+const AssetRecipe assetRecipes[ASSET_COUNT] = {
+    [ASSET_LOGO]       = { "logo",       "resources/logo.png",       ASSET_KIND_TEXTURE, 0,   0,   0 },
+    [ASSET_BALH]       = { "balh",       "resources/balh.png",       ASSET_KIND_TEXTURE, 0,   0,   0 },
+    [ASSET_PLAYER]     = { "pikachu",    "resources/pikachu.png",    ASSET_KIND_SPRITE,  0,   0,   0 },
+    [ASSET_ENEMY]      = { "pokeball",   "resources/pokeball.png",   ASSET_KIND_SPRITE,  0,   0,   0 },
+    [ASSET_ROCK]       = { "rock",       "resources/Rock.png",       ASSET_KIND_SPRITE,  0,   0,   3 },
+    [ASSET_ELIXIR]     = { "elixir",     "resources/elixir.png",     ASSET_KIND_SPRITE,  100, 100, 0 },
+    [ASSET_BOWLING_BG] = { "background", "resources/background.png", ASSET_KIND_TEXTURE, 0,   0,   0 },
+    [ASSET_FONT]       = { "emoji_font", "resources/emoji_font.ttf", ASSET_KIND_FONT,    0,   0,   0 },
+    [ASSET_HIT_SOUND]  = { "strike",     "resources/strike.wav",     ASSET_KIND_SOUND,   0,   0,   0 },
+};
+
+static unsigned int AlignUp(unsigned int value) {
+    return (value + ASSET_PACK_ALIGN - 1) & ~(unsigned int)(ASSET_PACK_ALIGN - 1);
+}
+
+// ------------ Cooking ------------
+Image CookImage(AssetId id) {
+    const AssetRecipe *recipe = &assetRecipes[id];
+    if (recipe->kind != ASSET_KIND_TEXTURE && recipe->kind != ASSET_KIND_SPRITE) return (Image){ 0 };
+    if (!FileExists(recipe->source)) {
+        TraceLog(LOG_WARNING, "%s missing!", recipe->source);
+        return (Image){ 0 };
+    }
+
+    Image image = LoadImage(recipe->source);
+    if (image.data == NULL) return image;
+
+    if (recipe->width > 0 && recipe->height > 0) ImageResize(&image, recipe->width, recipe->height);
+    else if (recipe->divisor > 1) ImageResize(&image, image.width / recipe->divisor, image.height / recipe->divisor);
+
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    return image;
+}
+
+bool WriteAssetPack(const char *fileName, const Image *images, int count) {
+    FILE *out = fopen(fileName, "wb");
+    if (out == NULL) return false;
+
+    AssetPackHeader header = { ASSET_PACK_MAGIC, ASSET_PACK_VERSION, (unsigned int)count, 0 };
+    AssetPackEntry entries[ASSET_COUNT] = { 0 };
+    if (count > ASSET_COUNT) count = ASSET_COUNT;
+
+    unsigned int offset = AlignUp(sizeof(header) + count*sizeof(AssetPackEntry));
+    for (int i = 0; i < count; i++) {
+        snprintf(entries[i].name, ASSET_NAME_LENGTH, "%s", assetRecipes[i].name);
+        if (images[i].data == NULL) continue;    // Kept in the index with no pixels
+
+        entries[i].width = images[i].width;
+        entries[i].height = images[i].height;
+        entries[i].mipmaps = 1;
+        entries[i].format = images[i].format;
+        entries[i].offset = offset;
+        entries[i].size = (unsigned int)GetPixelDataSize(images[i].width, images[i].height, images[i].format);
+        offset = AlignUp(offset + entries[i].size);
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1 &&
+              fwrite(entries, sizeof(AssetPackEntry), count, out) == (size_t)count;
+
+    static const unsigned char zeros[ASSET_PACK_ALIGN] = { 0 };
+    unsigned int written = (unsigned int)(sizeof(header) + count*sizeof(AssetPackEntry));
+    for (int i = 0; ok && i < count; i++) {
+        if (entries[i].size == 0) continue;
+        ok = fwrite(zeros, 1, entries[i].offset - written, out) == entries[i].offset - written &&
+             fwrite(images[i].data, 1, entries[i].size, out) == entries[i].size;
+        written = entries[i].offset + entries[i].size;
+    }
+
+    if (fclose(out) != 0) ok = false;
+    return ok;
+}
+
+// ------------ Runtime ------------
+bool OpenAssetPack(AssetPack *pack, const char *fileName) {
+    memset(pack, 0, sizeof(*pack));
+    if (!MapFile(&pack->file, fileName)) return false;
+
+    // The header is only read once the file is known to hold one
+    const AssetPackHeader *header = (const AssetPackHeader *)pack->file.data;
+    bool valid = pack->file.size >= sizeof(*header) && header->magic == ASSET_PACK_MAGIC && header->version == ASSET_PACK_VERSION &&
+                 pack->file.size >= sizeof(*header) + (size_t)header->count*sizeof(AssetPackEntry);
+    if (!valid) {
+        TraceLog(LOG_WARNING, "ASSETS: %s is not a version %d asset pack, re-run the cooker", fileName, ASSET_PACK_VERSION);
+        UnmapFile(&pack->file);
+        return false;
+    }
+
+    pack->entries = (const AssetPackEntry *)(pack->file.data + sizeof(*header));
+    pack->count = (int)header->count;
+    return true;
+}
+
+void CloseAssetPack(AssetPack *pack) {
+    UnmapFile(&pack->file);
+    memset(pack, 0, sizeof(*pack));
+}
+
+// Whether an entry's pixels lie inside the file and cover the image it describes; the cooker
+// writes one level per entry, and raylib's size math is only taken where it cannot overflow
+static bool EntryFits(const AssetPack *pack, const AssetPackEntry *entry) {
+    if (entry->size == 0 || (size_t)entry->offset + entry->size > pack->file.size) return false;
+    if (entry->width <= 0 || entry->height <= 0 || entry->mipmaps != 1) return false;
+    if ((long long)entry->width*entry->height > INT_MAX/128) return false;
+    int bytes = GetPixelDataSize(entry->width, entry->height, entry->format);
+    return bytes > 0 && entry->size >= (unsigned int)bytes;
+}
+
+Image GetPackedImage(const AssetPack *pack, AssetId id) {
+    const char *name = assetRecipes[id].name;
+    for (int i = 0; i < pack->count; i++) {
+        const AssetPackEntry *entry = &pack->entries[i];
+        if (strncmp(entry->name, name, ASSET_NAME_LENGTH) != 0) continue;
+        if (!EntryFits(pack, entry)) break;
+
+        // raylib only reads image data here, so the view can point straight into the mapping
+        return (Image){ (void *)(pack->file.data + entry->offset), entry->width, entry->height, entry->mipmaps, entry->format };
+    }
+    return (Image){ 0 };
+}
+
+Image LoadAssetImage(const AssetPack *pack, AssetId id) {
+    Image image = GetPackedImage(pack, id);
+    if (image.data == NULL) image = CookImage(id);
+    return image;
+}
+
+void ReleaseAssetImage(const AssetPack *pack, Image image) {
+    const unsigned char *data = image.data;
+    bool mapped = (data != NULL && data >= pack->file.data && data < pack->file.data + pack->file.size);
+    if (data != NULL && !mapped) UnloadImage(image);
+}
+
+Texture2D LoadAssetTexture(const AssetPack *pack, AssetId id) {
+    Image image = LoadAssetImage(pack, id);
+    Texture2D texture = { 0 };
+    if (image.data != NULL) texture = LoadTextureFromImage(image);
+    ReleaseAssetImage(pack, image);
+    return texture;
+}
@@ -0,0 +1,88 @@
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include "raylib.h"
+#include "mapfile.h"
+#include <stdbool.h>
+
+#define ASSET_PACK_FILE     "resources/assets.pack"
+#define ASSET_PACK_MAGIC    0x4B504743u    // "CGPK" little-endian
+#define ASSET_PACK_VERSION  1
+#define ASSET_NAME_LENGTH   32
+#define ASSET_PACK_ALIGN    64             // Pixel data offsets, so mapped rows start on a cache line
+
+// Every file the game loads; images are cooked into the pack in this order
+typedef enum {
+    ASSET_LOGO,
+    ASSET_BALH,
+    ASSET_PLAYER,
+    ASSET_ENEMY,
+    ASSET_ROCK,
+    ASSET_ELIXIR,
+    ASSET_BOWLING_BG,
+    ASSET_FONT,
+    ASSET_HIT_SOUND,
+    ASSET_COUNT
+} AssetId;
+
+typedef enum {
+    ASSET_KIND_TEXTURE,      // Image uploaded as its own texture
+    ASSET_KIND_SPRITE,       // Image kept on the CPU until it is packed into an atlas
+    ASSET_KIND_FONT,
+    ASSET_KIND_SOUND
+} AssetKind;
+
+// How a source file turns into what the game draws or plays
+typedef struct {
+    const char *name;        // Key in the pack index
+    const char *source;      // File under resources/
+    AssetKind kind;
+    int width;               // Resize target; 0 keeps the source size
+    int height;
+    int divisor;             // Shrink by this factor when no target is given; 0 or 1 keeps it
+} AssetRecipe;
+
+extern const AssetRecipe assetRecipes[ASSET_COUNT];
+
+// Pack layout: header, entry index, then raw pixel blobs at ASSET_PACK_ALIGN offsets
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int count;
+    unsigned int reserved;
+} AssetPackHeader;
+
+typedef struct {
+    char         name[ASSET_NAME_LENGTH];
+    int          width;
+    int          height;
+    int          mipmaps;
+    int          format;       // raylib PixelFormat of the blob
+    unsigned int offset;       // From the start of the file
+    unsigned int size;
+    unsigned int reserved[2];
+} AssetPackEntry;
+
+typedef struct {
+    MappedFile file;
+    const AssetPackEntry *entries;
+    int count;
+} AssetPack;
+
+// Decodes an image recipe's PNG and applies it; the slow path the cooker runs once at build time.
+// Fonts and sounds are not cooked and give an empty image.
+Image CookImage(AssetId id);
+bool WriteAssetPack(const char *fileName, const Image *images, int count);
+
+bool OpenAssetPack(AssetPack *pack, const char *fileName);
+void CloseAssetPack(AssetPack *pack);
+
+// Image viewing the mapped pixels (read-only, valid until CloseAssetPack), or data NULL
+Image GetPackedImage(const AssetPack *pack, AssetId id);
+
+// Packed view when the pack has it, otherwise a cooked copy; hand back with ReleaseAssetImage()
+Image LoadAssetImage(const AssetPack *pack, AssetId id);
+void ReleaseAssetImage(const AssetPack *pack, Image image);
+Texture2D LoadAssetTexture(const AssetPack *pack, AssetId id);
+
+#endif // ASSETS_H
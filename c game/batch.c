@@ -0,0 +1,170 @@
+#include "batch.h"
+#include "rlgl.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ATLAS_PADDING   2      // Keeps bilinear filtering from bleeding neighbours in
+#define MAX_ATLAS_SIZE  4096
+
+// ------------ Atlas ------------
+static bool ShelfPack(SpriteAtlas *atlas, const int *widths, const int *heights, const int *order, int count, int size) {
+    int x = ATLAS_PADDING, y = ATLAS_PADDING, shelfHeight = 0;
+
+    for (int k = 0; k < count; k++) {
+        int i = order[k];
+        int w = widths[i], h = heights[i];
+        if (w <= 0 || h <= 0) continue;
+        if (w + 2*ATLAS_PADDING > size) return false;
+
+        if (x + w + ATLAS_PADDING > size) {
+            x = ATLAS_PADDING;
+            y += shelfHeight + ATLAS_PADDING;
+            shelfHeight = 0;
+        }
+        if (y + h + ATLAS_PADDING > size) return false;
+
+        atlas->rects[i] = (Rectangle){ (float)x, (float)y, (float)w, (float)h };
+        x += w + ATLAS_PADDING;
+        if (h > shelfHeight) shelfHeight = h;
+    }
+    return true;
+}
+
+bool PackSpriteAtlas(SpriteAtlas *atlas, const int *widths, const int *heights, int count) {
+    if (count > MAX_ATLAS_SPRITES) return false;
+
+    memset(atlas, 0, sizeof(*atlas));
+    atlas->count = count;
+
+    // Tallest first keeps shelves tight
+    int order[MAX_ATLAS_SPRITES];
+    for (int i = 0; i < count; i++) {
+        order[i] = i;
+        atlas->present[i] = (widths[i] > 0 && heights[i] > 0);
+    }
+    for (int i = 1; i < count; i++) {
+        for (int j = i; j > 0 && heights[order[j]] > heights[order[j - 1]]; j--) {
+            int tmp = order[j]; order[j] = order[j - 1]; order[j - 1] = tmp;
+        }
+    }
+
+    for (int size = 64; size <= MAX_ATLAS_SIZE; size *= 2) {
+        if (ShelfPack(atlas, widths, heights, order, count, size)) {
+            atlas->width = size;
+            atlas->height = size;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LoadSpriteAtlas(SpriteAtlas *atlas, const Image *images, int count) {
+    int widths[MAX_ATLAS_SPRITES] = { 0 }, heights[MAX_ATLAS_SPRITES] = { 0 };
+    for (int i = 0; i < count && i < MAX_ATLAS_SPRITES; i++) {
+        bool valid = (images[i].data != NULL);
+        widths[i] = valid ? images[i].width : 0;
+        heights[i] = valid ? images[i].height : 0;
+    }
+    if (!PackSpriteAtlas(atlas, widths, heights, count)) {
+        TraceLog(LOG_WARNING, "ATLAS: Sprites do not fit in %dx%d", MAX_ATLAS_SIZE, MAX_ATLAS_SIZE);
+        return false;
+    }
+
+    Image canvas = GenImageColor(atlas->width, atlas->height, BLANK);
+    for (int i = 0; i < count; i++) {
+        if (!atlas->present[i]) continue;
+        Rectangle src = { 0, 0, (float)images[i].width, (float)images[i].height };
+        ImageDraw(&canvas, images[i], src, atlas->rects[i], WHITE);
+    }
+    atlas->texture = LoadTextureFromImage(canvas);
+    UnloadImage(canvas);
+
+    TraceLog(LOG_INFO, "ATLAS: Packed %d sprites into %dx%d", count, atlas->width, atlas->height);
+    return atlas->texture.id != 0;
+}
+
+void UnloadSpriteAtlas(SpriteAtlas *atlas) {
+    if (atlas->texture.id != 0) UnloadTexture(atlas->texture);
+    memset(atlas, 0, sizeof(*atlas));
+}
+
+// ------------ Batch ------------
+void InitSpriteBatch(SpriteBatch *batch) {
+    memset(batch, 0, sizeof(*batch));
+}
+
+void UnloadSpriteBatch(SpriteBatch *batch) {
+    free(batch->quads);
+    free(batch->sorted);
+    memset(batch, 0, sizeof(*batch));
+}
+
+void BeginSpriteBatch(SpriteBatch *batch, Rectangle view) {
+    batch->view = view;
+    batch->count = 0;
+    memset(&batch->stats, 0, sizeof(batch->stats));
+}
+
+void PushSprite(SpriteBatch *batch, const SpriteAtlas *atlas, int sprite, Rectangle dest, Color tint, int layer) {
+    batch->stats.sprites++;
+
+    // Frustum cull against the view
+    if (dest.x + dest.width < batch->view.x || dest.x > batch->view.x + batch->view.width ||
+        dest.y + dest.height < batch->view.y || dest.y > batch->view.y + batch->view.height) {
+        batch->stats.culled++;
+        return;
+    }
+
+    if (batch->count == batch->capacity) {
+        batch->capacity = (batch->capacity > 0) ? batch->capacity * 2 : 256;
+        batch->quads = realloc(batch->quads, batch->capacity * sizeof(SpriteQuad));
+        batch->sorted = realloc(batch->sorted, batch->capacity * sizeof(SpriteQuad));
+    }
+
+    if (layer < 0) layer = 0;
+    if (layer >= SPRITE_LAYERS) layer = SPRITE_LAYERS - 1;
+    batch->quads[batch->count++] = (SpriteQuad){ atlas->rects[sprite], dest, tint, layer };
+}
+
+void EndSpriteBatch(SpriteBatch *batch) {
+    // Stable counting sort by layer: layers draw back to front, push order within a layer
+    int start[SPRITE_LAYERS + 1] = { 0 };
+    for (int i = 0; i < batch->count; i++) start[batch->quads[i].layer + 1]++;
+    for (int l = 1; l <= SPRITE_LAYERS; l++) start[l] += start[l - 1];
+    for (int i = 0; i < batch->count; i++) batch->sorted[start[batch->quads[i].layer]++] = batch->quads[i];
+
+    // Everything shares the atlas texture, so rlgl only splits the stream when its buffer fills
+    batch->stats.quads = batch->count;
+    batch->stats.vertices = batch->count * 4;
+    batch->stats.drawCalls = (batch->count + RLGL_BATCH_QUADS - 1) / RLGL_BATCH_QUADS;
+}
+
+void DrawSpriteBatch(const SpriteBatch *batch, const SpriteAtlas *atlas) {
+    if (batch->count == 0) return;
+
+    // Without a texture rlgl binds its 1x1 white one, so the quads come out as solid tints
+    const float invW = 1.0f / (float)atlas->width;
+    const float invH = 1.0f / (float)atlas->height;
+
+    rlSetTexture(atlas->texture.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+
+    for (int i = 0; i < batch->count; i++) {
+        const SpriteQuad *q = &batch->sorted[i];
+        float u0 = q->source.x * invW, v0 = q->source.y * invH;
+        float u1 = (q->source.x + q->source.width) * invW, v1 = (q->source.y + q->source.height) * invH;
+        float x0 = q->dest.x, y0 = q->dest.y;
+        float x1 = q->dest.x + q->dest.width, y1 = q->dest.y + q->dest.height;
+
+        // Same corner order as DrawTexturePro(): top-left, bottom-left, bottom-right, top-right
+        rlColor4ub(q->tint.r, q->tint.g, q->tint.b, q->tint.a);
+        rlTexCoord2f(u0, v0); rlVertex2f(x0, y0);
+        rlTexCoord2f(u0, v1); rlVertex2f(x0, y1);
+        rlTexCoord2f(u1, v1); rlVertex2f(x1, y1);
+        rlTexCoord2f(u1, v0); rlVertex2f(x1, y0);
+    }
+
+    rlEnd();
+    rlSetTexture(0);
+}
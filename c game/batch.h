@@ -0,0 +1,62 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+#define MAX_ATLAS_SPRITES   16
+#define SPRITE_LAYERS       8
+#define RLGL_BATCH_QUADS    8192   // rlgl's default desktop batch size; one draw call per full buffer
+
+// Several sprite images packed into one texture so a whole scene binds a single texture
+typedef struct {
+    Texture2D texture;                       // id 0 until uploaded; the layout works without it
+    int       width;
+    int       height;
+    int       count;
+    Rectangle rects[MAX_ATLAS_SPRITES];      // Source rect of each sprite inside the atlas
+    bool      present[MAX_ATLAS_SPRITES];    // False when the sprite's image failed to load
+} SpriteAtlas;
+
+// Shelf-packs the given sizes into the smallest power-of-two atlas that holds them.
+// Zero-sized entries are marked missing. Pure layout: no image or GPU work.
+bool PackSpriteAtlas(SpriteAtlas *atlas, const int *widths, const int *heights, int count);
+
+// Packs, composes and uploads the images; images without data become missing sprites
+bool LoadSpriteAtlas(SpriteAtlas *atlas, const Image *images, int count);
+void UnloadSpriteAtlas(SpriteAtlas *atlas);
+
+typedef struct {
+    Rectangle source;
+    Rectangle dest;
+    Color     tint;
+    int       layer;
+} SpriteQuad;
+
+typedef struct {
+    int sprites;      // Pushed this frame
+    int culled;       // Rejected because they were entirely outside the view
+    int quads;        // Submitted
+    int vertices;
+    int drawCalls;
+} SpriteBatchStats;
+
+// One frame's sprites, submitted in layer order as a single quad stream on the atlas texture
+typedef struct {
+    Rectangle   view;         // Anything not overlapping this is culled
+    SpriteQuad *quads;        // Push order
+    SpriteQuad *sorted;       // Layer order, filled by EndSpriteBatch()
+    int         count;
+    int         capacity;     // Grows on demand and is kept, so steady-state frames do not allocate
+    SpriteBatchStats stats;   // Counters for the last finished batch; valid without a display
+} SpriteBatch;
+
+void InitSpriteBatch(SpriteBatch *batch);
+void UnloadSpriteBatch(SpriteBatch *batch);
+
+void BeginSpriteBatch(SpriteBatch *batch, Rectangle view);
+void PushSprite(SpriteBatch *batch, const SpriteAtlas *atlas, int sprite, Rectangle dest, Color tint, int layer);
+void EndSpriteBatch(SpriteBatch *batch);   // Sorts by layer and fills stats
+void DrawSpriteBatch(const SpriteBatch *batch, const SpriteAtlas *atlas);   // Solid quads until the atlas has a texture
+
+#endif // BATCH_H
@@ -0,0 +1,343 @@
+/*******************************************************************************************
+*
+*   Headless benchmark suite: scripted scenarios through the real StepWorld(), reported as JSON.
+*
+*   Usage: bench [--out file] [--baseline file] [--tolerance 0.20] [--only name] [--threads n]
+*          bench --list
+*
+*   Each scenario runs in its own child process (bench --run name) so its peak RSS is its own.
+*   The timed loop runs BENCH_REPEATS times from the same seed and the fastest pass is kept.
+*   --threads runs the world on the job system with that many threads (default 1); compare
+*   against a baseline taken with the same count.
+*
+*   With --baseline, any scenario whose ns/tick grows past the tolerance, whose allocations
+*   per tick grow at all, or whose peak RSS grows by more than 10% (+512 KB) fails the run (exit 1).
+*   Write a baseline on the machine that will compare against it: bench --out baseline.json
+*
+*   Allocations are counted when built with BENCH_COUNT_ALLOCS and -Wl,--wrap=malloc,...
+*   (the Makefile's bench target does this for GCC toolchains); otherwise they report -1.
+*
+********************************************************************************************/
+
+#include "world.h"
+#include "bot.h"
+#include "steer.h"
+#include "timing.h"
+#include "jobs.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_REPEATS       3
+#define BENCH_MAX_LINE      512
+
+typedef enum {
+    SCENARIO_SWARM,       // param enemies, topped up as the bot shoots them; godMode keeps the run alive
+    SCENARIO_STORM,       // param bullets fired from the bottom edge every tick into a 1000 enemy swarm
+    SCENARIO_FLOW,        // Like SCENARIO_SWARM on Hard, so the swarm follows the flow field around the rocks
+    SCENARIO_PATTERNS,    // param "storm" emitters round the player, started full so only the steady state is timed
+    SCENARIO_HARD,        // Hard runs with obstacles, restarted whenever they end
+    SCENARIO_BOWLING      // Back-to-back second-chance throws
+} ScenarioKind;
+
+typedef struct {
+    const char  *name;
+    ScenarioKind kind;
+    int          param;
+    int          ticks;
+} Scenario;
+
+static const Scenario scenarios[] = {
+    { "swarm_100",      SCENARIO_SWARM,   100,     5000 },
+    { "swarm_1k",       SCENARIO_SWARM,   1000,    5000 },
+    { "swarm_10k",      SCENARIO_SWARM,   10000,   1000 },
+    { "swarm_100k",     SCENARIO_SWARM,   100000,  200 },
+    { "swarm_1m",       SCENARIO_SWARM,   1000000, 30 },
+    { "bullet_storm",   SCENARIO_STORM,   200,     3000 },
+    { "flow_10k",       SCENARIO_FLOW,    10000,   1000 },
+    { "flow_100k",      SCENARIO_FLOW,    100000,  200 },
+    { "patterns_50k",   SCENARIO_PATTERNS, 8,      1000 },
+    { "hard_obstacles", SCENARIO_HARD,    0,       50000 },
+    { "bowling_throws", SCENARIO_BOWLING, 0,       50000 },
+};
+
+#define SCENARIO_COUNT ((int)(sizeof(scenarios)/sizeof(scenarios[0])))
+
+typedef struct {
+    double nsPerTick;
+    double allocsPerTick;
+    long   peakRssKb;
+} BenchResult;
+
+static int threads = 1;
+
+// ------------ Allocation counting ------------
+static unsigned long long allocations = 0;
+
+#if defined(BENCH_COUNT_ALLOCS)
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) { allocations++; return __real_malloc(size); }
+void *__wrap_calloc(size_t count, size_t size) { allocations++; return __real_calloc(count, size); }
+void *__wrap_realloc(void *ptr, size_t size) { allocations++; return __real_realloc(ptr, size); }
+#endif
+
+// ------------ Scenarios ------------
+static float RandomRange(float min, float max) {
+    return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+static void SpawnRing(World *world, int count) {
+    for (int i = 0; i < count; i++) {
+        // Spread over a wide ring so the swarm is still closing in when timing ends
+        float angle = RandomRange(0.0f, 2.0f*PI), distance = RandomRange(200.0f, 4000.0f);
+        SpawnEnemyAt(world, (Vector2){ 400.0f + cosf(angle)*distance, 300.0f + sinf(angle)*distance });
+    }
+}
+
+static int SwarmSize(const Scenario *scenario) {
+    return (scenario->kind == SCENARIO_SWARM || scenario->kind == SCENARIO_FLOW) ? scenario->param : 1000;
+}
+
+static void SetupScenario(World *world, const Scenario *scenario) {
+    InitWorld(world, 800.0f, 600.0f);
+    SeedWorld(world, 1);
+    srand(1);
+
+    switch (scenario->kind) {
+        case SCENARIO_SWARM:
+        case SCENARIO_STORM:
+        case SCENARIO_FLOW: {
+            StartRun(world, (scenario->kind == SCENARIO_FLOW) ? DIFFICULTY_HARD : DIFFICULTY_MEDIUM);
+            world->godMode = true;
+            SpawnRing(world, SwarmSize(scenario));
+        } break;
+        case SCENARIO_PATTERNS: {
+            StartRun(world, DIFFICULTY_EASY);
+            world->godMode = true;
+            for (int e = 0; e < scenario->param; e++) {
+                float angle = 2.0f*PI*e / scenario->param;
+                Vector2 facing = { cosf(angle), sinf(angle) };
+                AddEmitter(world, FindBulletPattern("storm"), (Vector2){ 400.0f + 200.0f*facing.x, 300.0f + 150.0f*facing.y }, facing);
+            }
+            for (int i = 0; i < 600; i++) StepWorld(world, BotInputs(world, world->tick), 1.0f / 60.0f);
+        } break;
+        case SCENARIO_HARD:
+        case SCENARIO_BOWLING: StartRun(world, DIFFICULTY_HARD); break;
+    }
+}
+
+static void StepScenario(World *world, const Scenario *scenario) {
+    WorldInputs inputs = BotInputs(world, world->tick);
+
+    switch (scenario->kind) {
+        case SCENARIO_SWARM:
+        case SCENARIO_STORM:
+        case SCENARIO_FLOW: {
+            int swarm = SwarmSize(scenario);
+            inputs.pressed &= ~INPUT_SPECIAL;   // The elixir would clear the swarm
+            world->score = 0;                   // Score shortens the spawn interval; keep the count near the swarm size
+            if (world->enemies.pool.count < swarm) SpawnRing(world, swarm - world->enemies.pool.count);
+            if (scenario->kind != SCENARIO_STORM) break;
+
+            for (int i = 0; i < scenario->param; i++) {
+                SpawnBulletAt(world, (Vector2){ RandomRange(0.0f, 800.0f), 600.0f }, (Vector2){ RandomRange(-100.0f, 100.0f), -400.0f }, 10.0f);
+            }
+        } break;
+        case SCENARIO_PATTERNS:
+        case SCENARIO_HARD: break;
+        case SCENARIO_BOWLING: {
+            // Put an enemy on the player so the next step goes straight to the throw
+            if (world->state == GAMEPLAY) SpawnEnemyAt(world, world->playerPos);
+        } break;
+    }
+
+    StepWorld(world, inputs, 1.0f / 60.0f);
+    if (world->state == CLOSING_SCENE) StartRun(world, world->difficulty);
+}
+
+static BenchResult RunScenario(const Scenario *scenario) {
+    BenchResult result = { 0 };
+    result.nsPerTick = -1.0;
+    result.allocsPerTick = -1.0;
+
+    static World world;
+    JobSystem jobs;
+    StartJobSystem(&jobs, threads);
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        SetupScenario(&world, scenario);
+        world.jobs = &jobs;
+
+        unsigned long long allocsBefore = allocations;
+        double start = NowSeconds();
+        for (int i = 0; i < scenario->ticks; i++) StepScenario(&world, scenario);
+        double elapsed = NowSeconds() - start;
+        unsigned long long allocs = allocations - allocsBefore;
+
+        double ns = elapsed * 1e9 / scenario->ticks;
+        if (result.nsPerTick < 0.0 || ns < result.nsPerTick) result.nsPerTick = ns;
+#if defined(BENCH_COUNT_ALLOCS)
+        double perTick = (double)allocs / scenario->ticks;
+        if (result.allocsPerTick < 0.0 || perTick < result.allocsPerTick) result.allocsPerTick = perTick;
+#else
+        (void)allocs;
+#endif
+        UnloadWorld(&world);
+    }
+    StopJobSystem(&jobs);
+
+    result.peakRssKb = (long)(PeakRssBytes() / 1024);
+    return result;
+}
+
+// ------------ Driver ------------
+static const Scenario *FindScenario(const char *name) {
+    for (int i = 0; i < SCENARIO_COUNT; i++) {
+        if (strcmp(scenarios[i].name, name) == 0) return &scenarios[i];
+    }
+    return NULL;
+}
+
+static void PrintResult(FILE *out, const Scenario *scenario, BenchResult result) {
+    fprintf(out, "{\"name\": \"%s\", \"ticks\": %d, \"ns_per_tick\": %.1f, \"allocs_per_tick\": %.4f, \"peak_rss_kb\": %ld}",
+            scenario->name, scenario->ticks, result.nsPerTick, result.allocsPerTick, result.peakRssKb);
+}
+
+// Runs one scenario in a child process and parses the JSON object it prints
+static bool RunIsolated(const char *self, const Scenario *scenario, BenchResult *result) {
+    char command[BENCH_MAX_LINE];
+    snprintf(command, sizeof(command), "\"%s\" --threads %d --run %s", self, threads, scenario->name);
+
+    FILE *child = popen(command, "r");
+    if (child == NULL) return false;
+
+    char line[BENCH_MAX_LINE] = { 0 };
+    bool ok = (fgets(line, sizeof(line), child) != NULL);
+    if (pclose(child) != 0) ok = false;
+
+    const char *ns = strstr(line, "\"ns_per_tick\":");
+    const char *allocs = strstr(line, "\"allocs_per_tick\":");
+    const char *rss = strstr(line, "\"peak_rss_kb\":");
+    if (!ok || ns == NULL || allocs == NULL || rss == NULL) return false;
+
+    result->nsPerTick = atof(ns + strlen("\"ns_per_tick\":"));
+    result->allocsPerTick = atof(allocs + strlen("\"allocs_per_tick\":"));
+    result->peakRssKb = atol(rss + strlen("\"peak_rss_kb\":"));
+    return true;
+}
+
+// Finds a scenario's object in a baseline written by this tool
+static bool FindBaseline(const char *json, const char *name, BenchResult *result) {
+    char key[128];
+    snprintf(key, sizeof(key), "\"name\": \"%s\"", name);
+    const char *entry = (json != NULL) ? strstr(json, key) : NULL;
+    if (entry == NULL) return false;
+
+    const char *end = strchr(entry, '}');
+    const char *ns = strstr(entry, "\"ns_per_tick\":");
+    const char *allocs = strstr(entry, "\"allocs_per_tick\":");
+    const char *rss = strstr(entry, "\"peak_rss_kb\":");
+    if (end == NULL || ns == NULL || allocs == NULL || rss == NULL || ns > end || allocs > end || rss > end) return false;
+
+    result->nsPerTick = atof(ns + strlen("\"ns_per_tick\":"));
+    result->allocsPerTick = atof(allocs + strlen("\"allocs_per_tick\":"));
+    result->peakRssKb = atol(rss + strlen("\"peak_rss_kb\":"));
+    return true;
+}
+
+static char *ReadTextFile(const char *fileName) {
+    FILE *file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char *text = malloc((size_t)size + 1);
+    size_t read = fread(text, 1, (size_t)size, file);
+    text[read] = '\0';
+    fclose(file);
+    return text;
+}
+
+int main(int argc, char **argv) {
+    const char *outFile = NULL, *baselineFile = NULL, *only = NULL;
+    double tolerance = 0.20;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = (i + 1 < argc);
+        if (strcmp(argv[i], "--run") == 0 && hasValue) {
+            const Scenario *scenario = FindScenario(argv[i + 1]);
+            if (scenario == NULL) return 2;
+            PrintResult(stdout, scenario, RunScenario(scenario));
+            printf("\n");
+            return 0;
+        }
+        if (strcmp(argv[i], "--list") == 0) {
+            for (int s = 0; s < SCENARIO_COUNT; s++) printf("%s\n", scenarios[s].name);
+            return 0;
+        }
+        if (strcmp(argv[i], "--out") == 0 && hasValue) outFile = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && hasValue) baselineFile = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && hasValue) tolerance = atof(argv[++i]);
+        else if (strcmp(argv[i], "--only") == 0 && hasValue) only = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && hasValue) threads = atoi(argv[++i]);
+    }
+
+    char *baseline = NULL;
+    if (baselineFile != NULL) {
+        baseline = ReadTextFile(baselineFile);
+        if (baseline == NULL) fprintf(stderr, "bench: no baseline at %s, nothing to compare against\n", baselineFile);
+    }
+
+    FILE *out = (outFile != NULL) ? fopen(outFile, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "bench: cannot write %s\n", outFile);
+        return 2;
+    }
+
+    fprintf(out, "{\n  \"steer\": \"%s\",\n  \"threads\": %d,\n  \"scenarios\": [\n", SteerEnemiesPath(), threads);
+    int regressions = 0, failures = 0;
+    bool first = true;
+
+    for (int s = 0; s < SCENARIO_COUNT; s++) {
+        const Scenario *scenario = &scenarios[s];
+        if (only != NULL && strcmp(only, scenario->name) != 0) continue;
+
+        BenchResult result;
+        if (!RunIsolated(argv[0], scenario, &result)) {
+            fprintf(stderr, "%-16s FAILED to run\n", scenario->name);
+            failures++;
+            continue;
+        }
+
+        fprintf(out, "%s    ", first ? "" : ",\n");
+        PrintResult(out, scenario, result);
+        first = false;
+
+        BenchResult base;
+        const char *verdict = "";
+        if (FindBaseline(baseline, scenario->name, &base)) {
+            bool slower = result.nsPerTick > base.nsPerTick * (1.0 + tolerance);
+            bool allocates = result.allocsPerTick > base.allocsPerTick + 0.0001;
+            bool bigger = result.peakRssKb > base.peakRssKb + base.peakRssKb / 10 + 512;   // Slack for allocator noise
+            if (slower || allocates || bigger) {
+                regressions++;
+                verdict = slower ? "  REGRESSED (time)" : allocates ? "  REGRESSED (allocations)" : "  REGRESSED (memory)";
+            } else {
+                verdict = "  ok";
+            }
+        }
+        fprintf(stderr, "%-16s %12.1f ns/tick %10.4f allocs/tick %8ld KB peak%s\n",
+                scenario->name, result.nsPerTick, result.allocsPerTick, result.peakRssKb, verdict);
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) fclose(out);
+    free(baseline);
+
+    if (regressions > 0) fprintf(stderr, "bench: %d scenario(s) regressed past the baseline\n", regressions);
+    return (regressions > 0 || failures > 0) ? 1 : 0;
+}
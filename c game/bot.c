@@ -0,0 +1,18 @@
+#include "bot.h"
+
+WorldInputs BotInputs(const World *world, unsigned long long tick) {
+    WorldInputs inputs = { 0 };
+
+    if (world->state == GAMEPLAY) {
+        inputs.down |= ((tick / 120) % 2 == 0) ? INPUT_LEFT : INPUT_RIGHT;
+        if ((tick / 90) % 4 == 0) inputs.down |= INPUT_UP;
+        if ((tick / 90) % 4 == 2) inputs.down |= INPUT_DOWN;
+        if (tick % 6 == 0) inputs.pressed |= INPUT_FIRE;
+        if (world->elixirReady) inputs.pressed |= INPUT_SPECIAL;
+    } else if (world->state == MINI_GAME && !world->ballLaunched) {
+        if (world->power < 0.9f) inputs.down |= INPUT_FIRE;
+        else inputs.released |= INPUT_FIRE;
+    }
+
+    return inputs;
+}
@@ -0,0 +1,9 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "world.h"
+
+// Deterministic stand-in for a player: strafe, fire steadily, bowl with a long charge
+WorldInputs BotInputs(const World *world, unsigned long long tick);
+
+#endif // BOT_H
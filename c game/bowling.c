@@ -0,0 +1,411 @@
+#include "bowling.h"
+#include <math.h>
+
+#define SAMPLE_BATCH  4096    // Throws per job batch
+#define PLAN_GRAIN    64
+
+const float maxAngle = PI / 6;
+const float maxPower = 1.0f;
+
+BowlingRules DefaultBowlingRules(void) {
+    return (BowlingRules){
+        .pathA = 100.0f,
+        .pathB = 500.0f,
+        .baseSpeed = 0.02f,
+        .powerSpeed = 0.05f,
+        .maxAngle = maxAngle,
+        .maxPower = maxPower,
+        .strikeAngle = 0.1f,
+        .strikePower = 0.8f,
+        .strikeScatter = 8.0f,
+        .ballRestitution = 0.3f,
+        .pinRestitution = 0.5f,
+        .pinFriction = 0.4f,
+        .toppleSpeed = 1.5f,
+        .sleepSpeed = 0.1f
+    };
+}
+
+BowlingLane BowlingLaneFor(float width, float height) {
+    BowlingLane lane = { 0 };
+    lane.pathCentre = (Vector2){ width/2.0f, height + 50 };
+
+    const float cx = width / 2.0f;
+    const float topY = 120.0f;
+    const float spacing = 35.0f;
+    int idx = 0;
+    for (int row = 0; row < 4; row++) {
+        for (int i = 0; i <= row && idx < NUM_PINS; i++) {
+            lane.pins[idx++] = (Vector2){ cx + (i - row / 2.0f) * spacing, topY + row * spacing };
+        }
+    }
+
+    for (int i = 0; i < NUM_PINS; i++) {
+        if (lane.pins[i].y > lane.reachY) lane.reachY = lane.pins[i].y;
+    }
+    lane.reachY += PIN_RADIUS + BALL_RADIUS + 1.0f;
+    return lane;
+}
+
+// ------------ One throw ------------
+float BowlingBallSpeed(const BowlingRules *rules, float power) {
+    return rules->baseSpeed + power * rules->powerSpeed;
+}
+
+// The angle's sine and cosine are passed in so the evaluator works them out once per throw;
+// the arithmetic is the same either way, so both land on the same bits
+static Vector2 BallOnPath(const BowlingRules *rules, Vector2 pathCentre, float cosAngle, float sinAngle, float t) {
+    float x = rules->pathA * cosf(t);
+    float y = rules->pathB * sinf(t);
+    Vector2 ball = {
+        pathCentre.x + x * cosAngle - y * sinAngle,
+        pathCentre.y - x * sinAngle - y * cosAngle
+    };
+
+    if (ball.x < LANE_LEFT + BALL_RADIUS) ball.x = LANE_LEFT + BALL_RADIUS;
+    if (ball.x > LANE_RIGHT - BALL_RADIUS) ball.x = LANE_RIGHT - BALL_RADIUS;
+    return ball;
+}
+
+Vector2 BowlingBallAt(const BowlingRules *rules, Vector2 pathCentre, float throwAngle, float t) {
+    return BallOnPath(rules, pathCentre, cosf(throwAngle), sinf(throwAngle), t);
+}
+
+bool IsStrikeThrow(const BowlingRules *rules, BowlingThrow bowl) {
+    return (bowl.strikeMode && bowl.luckyStrike) || (fabsf(bowl.throwAngle) < rules->strikeAngle && bowl.power > rules->strikePower);
+}
+
+// ------------ Pin physics ------------
+void RackPins(Pin *pins, const BowlingLane *lane) {
+    for (int i = 0; i < NUM_PINS; i++) pins[i] = (Pin){ .position = lane->pins[i], .asleep = true };
+}
+
+static void Wake(Pin *pin) {
+    pin->asleep = false;
+    pin->restTime = 0.0f;
+}
+
+static void Topple(const BowlingRules *rules, Pin *pin, float impulse, unsigned int bit, unsigned int *felled) {
+    if (!pin->fallen && impulse > rules->toppleSpeed) {
+        pin->fallen = true;
+        *felled |= bit;
+    }
+}
+
+static void CollideBall(const BowlingRules *rules, Pin *pins, Vector2 ballFrom, Vector2 ball, bool strike, float frames, unsigned int *felled) {
+    const float reach = BALL_RADIUS + PIN_RADIUS;
+    Vector2 ballVelocity = { (ball.x - ballFrom.x) / frames, (ball.y - ballFrom.y) / frames };
+
+    for (int i = 0; i < NUM_PINS; i++) {
+        Pin *pin = &pins[i];
+        float dx = pin->position.x - ball.x, dy = pin->position.y - ball.y, d2 = dx*dx + dy*dy;
+        if (d2 > reach*reach) continue;
+
+        if (strike && !pin->fallen) {
+            // Every pin flies straight away from the ball
+            for (int k = 0; k < NUM_PINS; k++) {
+                float kx = pins[k].position.x - ball.x, ky = pins[k].position.y - ball.y, d = sqrtf(kx*kx + ky*ky);
+                Vector2 away = (d > 0.0f) ? (Vector2){ kx / d, ky / d } : (Vector2){ 0.0f, -1.0f };
+                pins[k].velocity = (Vector2){ away.x * rules->strikeScatter, away.y * rules->strikeScatter };
+                if (!pins[k].fallen) *felled |= 1u << k;
+                pins[k].fallen = true;
+                Wake(&pins[k]);
+            }
+            strike = false;
+        }
+
+        // The ball is kinematic: it shoves the pin clear and keeps its own path
+        float d = sqrtf(d2);
+        Vector2 n = (d > 0.0f) ? (Vector2){ dx / d, dy / d } : (Vector2){ 0.0f, -1.0f };
+        pin->position = (Vector2){ ball.x + n.x * reach, ball.y + n.y * reach };
+        float vn = (pin->velocity.x - ballVelocity.x) * n.x + (pin->velocity.y - ballVelocity.y) * n.y;
+        if (vn < 0.0f) {
+            float impulse = -(1.0f + rules->ballRestitution) * vn;
+            pin->velocity.x += n.x * impulse;
+            pin->velocity.y += n.y * impulse;
+            Topple(rules, pin, impulse, 1u << i, felled);
+        }
+        Wake(pin);
+    }
+}
+
+static void CollidePins(const BowlingRules *rules, Pin *pins, unsigned int *felled) {
+    const float reach = 2.0f * PIN_CONTACT_RADIUS;
+    for (int i = 0; i < NUM_PINS; i++) {
+        for (int j = i + 1; j < NUM_PINS; j++) {
+            Pin *a = &pins[i], *b = &pins[j];
+            if (a->asleep && b->asleep) continue;
+            float dx = b->position.x - a->position.x, dy = b->position.y - a->position.y, d2 = dx*dx + dy*dy;
+            if (d2 >= reach*reach) continue;
+
+            // Equal masses: each takes half the overlap and half the impulse
+            float d = sqrtf(d2);
+            Vector2 n = (d > 0.0f) ? (Vector2){ dx / d, dy / d } : (Vector2){ 1.0f, 0.0f };
+            float push = 0.5f * (reach - d);
+            a->position.x -= n.x * push;
+            a->position.y -= n.y * push;
+            b->position.x += n.x * push;
+            b->position.y += n.y * push;
+
+            float vn = (b->velocity.x - a->velocity.x) * n.x + (b->velocity.y - a->velocity.y) * n.y;
+            if (vn >= 0.0f) continue;
+            float impulse = -0.5f * (1.0f + rules->pinRestitution) * vn;
+            a->velocity.x -= n.x * impulse;
+            a->velocity.y -= n.y * impulse;
+            b->velocity.x += n.x * impulse;
+            b->velocity.y += n.y * impulse;
+            Topple(rules, a, impulse, 1u << i, felled);
+            Topple(rules, b, impulse, 1u << j, felled);
+            Wake(a);
+            Wake(b);
+        }
+    }
+}
+
+static void MovePin(const BowlingRules *rules, Pin *pin, float frames) {
+    float speed = sqrtf(pin->velocity.x * pin->velocity.x + pin->velocity.y * pin->velocity.y);
+    float slowed = speed - rules->pinFriction * frames;
+    if (slowed <= 0.0f) {
+        pin->velocity = (Vector2){ 0.0f, 0.0f };
+        slowed = 0.0f;
+    } else {
+        pin->velocity.x *= slowed / speed;
+        pin->velocity.y *= slowed / speed;
+    }
+
+    pin->position.x += pin->velocity.x * frames;
+    pin->position.y += pin->velocity.y * frames;
+    if (pin->fallen) pin->rotation += slowed * frames * 3.0f;
+
+    const float left = LANE_LEFT + PIN_CONTACT_RADIUS, right = LANE_RIGHT - PIN_CONTACT_RADIUS, top = LANE_TOP + PIN_CONTACT_RADIUS;
+    if (pin->position.x < left) {
+        pin->position.x = left;
+        if (pin->velocity.x < 0.0f) pin->velocity.x *= -rules->pinRestitution;
+    }
+    if (pin->position.x > right) {
+        pin->position.x = right;
+        if (pin->velocity.x > 0.0f) pin->velocity.x *= -rules->pinRestitution;
+    }
+    if (pin->position.y < top) {
+        pin->position.y = top;
+        if (pin->velocity.y < 0.0f) pin->velocity.y *= -rules->pinRestitution;
+    }
+
+    pin->restTime = (slowed < rules->sleepSpeed) ? pin->restTime + frames : 0.0f;
+    if (pin->restTime >= PIN_SLEEP_FRAMES) {
+        pin->asleep = true;
+        pin->velocity = (Vector2){ 0.0f, 0.0f };
+    }
+}
+
+unsigned int StepPins(const BowlingRules *rules, Pin *pins, Vector2 ballFrom, Vector2 ballTo, bool ballInPlay, bool strike, float frames) {
+    unsigned int felled = 0;
+    if (ballInPlay) CollideBall(rules, pins, ballFrom, ballTo, strike, frames, &felled);
+    if (PinsAsleep(pins)) return felled;   // A settled rack costs nothing more
+
+    CollidePins(rules, pins, &felled);
+    for (int i = 0; i < NUM_PINS; i++) {
+        if (!pins[i].asleep) MovePin(rules, &pins[i], frames);
+    }
+    return felled;
+}
+
+bool PinsAsleep(const Pin *pins) {
+    for (int i = 0; i < NUM_PINS; i++) {
+        if (!pins[i].asleep) return false;
+    }
+    return true;
+}
+
+unsigned int FallenPins(const Pin *pins) {
+    unsigned int fallen = 0;
+    for (int i = 0; i < NUM_PINS; i++) {
+        if (pins[i].fallen) fallen |= 1u << i;
+    }
+    return fallen;
+}
+
+// ------------ One throw, start to finish ------------
+unsigned int EvaluateThrow(const BowlingRules *rules, const BowlingLane *lane, BowlingThrow bowl) {
+    float speed = BowlingBallSpeed(rules, bowl.power);
+    if (speed <= 0.0f) return 0;
+
+    // The ball sits at least pathCentre.y - pathA|sin angle| - pathB sin t down the screen, so
+    // every frame before sin t clears the gap to the rack only advances t: the pins sleep on
+    // their spots until the ball first reaches one
+    float cosAngle = cosf(bowl.throwAngle), sinAngle = sinf(bowl.throwAngle);
+    float gap = (lane->pathCentre.y - rules->pathA * fabsf(sinAngle) - lane->reachY) / rules->pathB;
+    if (gap >= 1.0f) return 0;
+    float reachT = (gap > 0.0f) ? asinf(gap) - 0.01f : -1.0f;
+
+    Pin pins[NUM_PINS];
+    RackPins(pins, lane);
+    bool strike = IsStrikeThrow(rules, bowl);
+    Vector2 ball = { 0 };
+    bool ballFresh = false;   // ball holds the previous frame's position
+    for (float t = 0.0f; t < PI / 2; ) {
+        float from = t;
+        t += speed;   // Accumulated like the MINI_GAME's, so every frame lands on the same t
+        if (t < reachT) continue;
+
+        Vector2 ballFrom = ballFresh ? ball : BallOnPath(rules, lane->pathCentre, cosAngle, sinAngle, from);
+        ball = BallOnPath(rules, lane->pathCentre, cosAngle, sinAngle, t);
+        ballFresh = true;
+        StepPins(rules, pins, ballFrom, ball, true, strike, 1.0f);
+    }
+
+    // Pin action after the ball has gone, as long as the MINI_GAME waits for it
+    float settle = 0.0f;
+    while (!PinsAsleep(pins) && settle < PIN_SETTLE_LIMIT) {
+        settle += 1.0f;
+        StepPins(rules, pins, ball, ball, false, strike, 1.0f);
+    }
+    return FallenPins(pins);
+}
+
+// ------------ Batches ------------
+typedef struct {
+    const BowlingRules *rules;
+    const BowlingLane  *lane;
+    const BowlingThrow *throws;
+    unsigned short     *knocked;
+} EvaluateJob;
+
+static void EvaluateThrowsJob(void *context, int begin, int end, int worker) {
+    EvaluateJob *job = context;
+    for (int i = begin; i < end; i++) job->knocked[i] = (unsigned short)EvaluateThrow(job->rules, job->lane, job->throws[i]);
+}
+
+void EvaluateThrows(JobSystem *jobs, const BowlingRules *rules, const BowlingLane *lane,
+                    const BowlingThrow *throws, unsigned short *knocked, int count) {
+    EvaluateJob job = { rules, lane, throws, knocked };
+    ParallelFor(jobs, count, SAMPLE_BATCH, EvaluateThrowsJob, &job);
+}
+
+// SplitMix64 over the throw's index: any throw can be drawn without drawing the ones before it
+static unsigned long long MixBits(unsigned long long x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static float UnitFrom(unsigned long long bits) {
+    return (float)(bits & 0xFFFFFF) / 16777216.0f;   // 24 bits: every value exact in a float
+}
+
+typedef struct {
+    const BowlingRules *rules;
+    const BowlingLane  *lane;
+    ThrowDistribution   distribution;
+    long long           count;
+    unsigned long long  seed;
+    BowlingStats        perWorker[JOB_MAX_THREADS];
+} SampleJob;
+
+static void AddStats(BowlingStats *into, const BowlingStats *from) {
+    into->throws += from->throws;
+    into->strikes += from->strikes;
+    for (int p = 0; p <= NUM_PINS; p++) into->byPinsDown[p] += from->byPinsDown[p];
+    for (int p = 0; p < NUM_PINS; p++) into->pinFalls[p] += from->pinFalls[p];
+}
+
+static void SampleThrowsJob(void *context, int begin, int end, int worker) {
+    SampleJob *job = context;
+    const ThrowDistribution *d = &job->distribution;
+    BowlingStats local = { 0 }, *stats = &local;   // Neighbouring workers' totals share cache lines
+
+    for (int batch = begin; batch < end; batch++) {
+        long long first = (long long)batch * SAMPLE_BATCH;
+        long long last = (first + SAMPLE_BATCH < job->count) ? first + SAMPLE_BATCH : job->count;
+        for (long long i = first; i < last; i++) {
+            unsigned long long a = MixBits(job->seed ^ MixBits((unsigned long long)i));
+            unsigned long long b = MixBits(a);
+            BowlingThrow bowl = {
+                .throwAngle = d->minAngle + (d->maxAngle - d->minAngle) * UnitFrom(a),
+                .power = d->minPower + (d->maxPower - d->minPower) * UnitFrom(a >> 32),
+                .strikeMode = UnitFrom(b) < d->strikeModeChance,
+                .luckyStrike = (b >> 63) != 0
+            };
+
+            unsigned int knocked = EvaluateThrow(job->rules, job->lane, bowl);
+            int down = 0;
+            for (int p = 0; p < NUM_PINS; p++) {
+                if (knocked & (1u << p)) {
+                    stats->pinFalls[p]++;
+                    down++;
+                }
+            }
+            stats->byPinsDown[down]++;
+            stats->strikes += (knocked == ALL_PINS);
+            stats->throws++;
+        }
+    }
+
+    AddStats(&job->perWorker[worker], &local);
+}
+
+BowlingStats SampleThrows(JobSystem *jobs, const BowlingRules *rules, const BowlingLane *lane,
+                          ThrowDistribution distribution, long long count, unsigned long long seed) {
+    SampleJob job = { rules, lane, distribution, count, seed, { { 0 } } };
+    int batches = (int)((count + SAMPLE_BATCH - 1) / SAMPLE_BATCH);
+    ParallelFor(jobs, batches, 1, SampleThrowsJob, &job);
+
+    // Integer counts, so the merge order cannot change the totals
+    BowlingStats total = { 0 };
+    for (int w = 0; w < JOB_MAX_THREADS; w++) AddStats(&total, &job.perWorker[w]);
+    return total;
+}
+
+// ------------ Assist ------------
+typedef struct {
+    int   pins;
+    float angle;
+    float power;
+} PlanCandidate;
+
+typedef struct {
+    const BowlingRules *rules;
+    const BowlingLane  *lane;
+    int angleSteps, powerSteps;
+    PlanCandidate best[JOB_MAX_THREADS];
+} PlanJob;
+
+static bool Better(PlanCandidate a, PlanCandidate b) {
+    if (a.pins != b.pins) return a.pins > b.pins;
+    if (fabsf(a.angle) != fabsf(b.angle)) return fabsf(a.angle) < fabsf(b.angle);
+    if (a.power != b.power) return a.power < b.power;
+    return a.angle < b.angle;
+}
+
+static float GridValue(float min, float max, int i, int steps) {
+    return (steps > 1) ? min + (max - min) * (float)i / (float)(steps - 1) : 0.5f * (min + max);
+}
+
+static void PlanJobRun(void *context, int begin, int end, int worker) {
+    PlanJob *job = context;
+    for (int i = begin; i < end; i++) {
+        BowlingThrow bowl = {
+            .throwAngle = GridValue(-job->rules->maxAngle, job->rules->maxAngle, i / job->powerSteps, job->angleSteps),
+            .power = GridValue(0.0f, job->rules->maxPower, i % job->powerSteps, job->powerSteps)
+        };
+        unsigned int knocked = EvaluateThrow(job->rules, job->lane, bowl);
+        int pins = 0;
+        for (int p = 0; p < NUM_PINS; p++) pins += (knocked >> p) & 1u;
+
+        PlanCandidate candidate = { pins, bowl.throwAngle, bowl.power };
+        if (job->best[worker].pins < 0 || Better(candidate, job->best[worker])) job->best[worker] = candidate;
+    }
+}
+
+BowlingThrow PlanThrow(JobSystem *jobs, const BowlingRules *rules, const BowlingLane *lane, int angleSteps, int powerSteps) {
+    PlanJob job = { rules, lane, (angleSteps > 0) ? angleSteps : 1, (powerSteps > 0) ? powerSteps : 1, { { 0 } } };
+    for (int w = 0; w < JOB_MAX_THREADS; w++) job.best[w].pins = -1;
+    ParallelFor(jobs, job.angleSteps * job.powerSteps, PLAN_GRAIN, PlanJobRun, &job);
+
+    PlanCandidate best = { -1, 0.0f, 0.0f };
+    for (int w = 0; w < JOB_MAX_THREADS; w++) {
+        if (job.best[w].pins >= 0 && (best.pins < 0 || Better(job.best[w], best))) best = job.best[w];
+    }
+    return (BowlingThrow){ .throwAngle = best.angle, .power = best.power };
+}
@@ -0,0 +1,117 @@
+#ifndef BOWLING_H
+#define BOWLING_H
+
+#include "raylib.h"
+#include "jobs.h"
+#include <stdbool.h>
+
+#define NUM_PINS      10
+#define BALL_RADIUS   15
+#define PIN_RADIUS    20      // Drawn size, and how close the ball comes to knock one
+#define PIN_CONTACT_RADIUS 14 // Pins hit each other at the waist, so a racked set starts apart
+#define LANE_LEFT     140
+#define LANE_RIGHT    660
+#define LANE_TOP      60      // Back of the lane; pins bounce off it and the sides
+#define ALL_PINS      ((1u << NUM_PINS) - 1)   // Pin masks: bit i is pin i
+#define PIN_SLEEP_FRAMES   10 // 60 Hz frames a pin has to stay slow before it sleeps
+#define PIN_SETTLE_LIMIT  240 // Frames a rack gets to settle after the ball has gone
+
+extern const float maxAngle;   // The game's limits, which the aim and power gauges are drawn against
+extern const float maxPower;
+
+// Tunables of a throw; DefaultBowlingRules() gives the game's
+typedef struct {
+    float pathA;          // Semi-axes of the ellipse the ball rolls along
+    float pathB;
+    float baseSpeed;      // Path parameter gained per 60 Hz frame at zero power
+    float powerSpeed;     // Extra per unit of power
+    float maxAngle;
+    float maxPower;
+    float strikeAngle;    // A throw straighter than strikeAngle with more than strikePower
+    float strikePower;    // knocks the whole rack on its first touch
+    float strikeScatter;  // Speed a strike sends every pin away from the ball at
+
+    // Pin physics; speeds are pixels per 60 Hz frame
+    float ballRestitution;
+    float pinRestitution; // Between pins, and against the lane's walls
+    float pinFriction;    // Speed a sliding pin loses per frame
+    float toppleSpeed;    // A standing pin falls when a hit changes its speed by more than this
+    float sleepSpeed;     // Slower than this for PIN_SLEEP_FRAMES and a pin sleeps
+} BowlingRules;
+
+// A pin on the lane. Asleep pins are skipped entirely until something hits them.
+typedef struct {
+    Vector2 position;
+    Vector2 velocity;     // Pixels per 60 Hz frame
+    float rotation;       // Degrees; a fallen pin rolls as it slides
+    float restTime;       // Frames spent slower than sleepSpeed
+    bool fallen;
+    bool asleep;
+} Pin;
+
+// Where the rack and the ball's path sit on a playfield of a given size
+typedef struct {
+    Vector2 pathCentre;
+    Vector2 pins[NUM_PINS];
+    float   reachY;       // The ball has to come above this line to touch any racked pin
+} BowlingLane;
+
+typedef struct {
+    float throwAngle;
+    float power;
+    bool  strikeMode;
+    bool  luckyStrike;    // The coin strike mode flipped; only counts in strike mode
+} BowlingThrow;
+
+BowlingRules DefaultBowlingRules(void);
+BowlingLane  BowlingLaneFor(float width, float height);
+
+// Pieces the MINI_GAME steps with, shared so the evaluator below matches it exactly
+float   BowlingBallSpeed(const BowlingRules *rules, float power);
+Vector2 BowlingBallAt(const BowlingRules *rules, Vector2 pathCentre, float throwAngle, float t);   // Kept inside the lane
+bool    IsStrikeThrow(const BowlingRules *rules, BowlingThrow bowl);
+
+// ------------ Pin physics ------------
+void RackPins(Pin *pins, const BowlingLane *lane);   // Standing and asleep on their spots
+
+// Advances the pins by `frames` 60 Hz frames: the ball (kinematic, moving from ballFrom to
+// ballTo over the step) and the pins collide through impulses, then the awake pins slide and
+// fall asleep once slow. With strike set, the ball's first touch fells the whole rack.
+// Returns the pins felled during the step.
+unsigned int StepPins(const BowlingRules *rules, Pin *pins, Vector2 ballFrom, Vector2 ballTo, bool ballInPlay, bool strike, float frames);
+bool         PinsAsleep(const Pin *pins);
+unsigned int FallenPins(const Pin *pins);
+
+// Pins a throw fells, playing it the way the MINI_GAME does at 60 Hz: the ball rolls its path
+// through the pin physics, then the rack settles. Pure: no randomness, no world.
+unsigned int EvaluateThrow(const BowlingRules *rules, const BowlingLane *lane, BowlingThrow bowl);
+
+// ------------ Batches ------------
+// knocked[i] = EvaluateThrow(throws[i]), spread over the job system (jobs may be NULL)
+void EvaluateThrows(JobSystem *jobs, const BowlingRules *rules, const BowlingLane *lane,
+                    const BowlingThrow *throws, unsigned short *knocked, int count);
+
+typedef struct {
+    float minAngle, maxAngle;
+    float minPower, maxPower;
+    float strikeModeChance;   // Share of throws in strike mode; each of those flips a fair coin
+} ThrowDistribution;
+
+typedef struct {
+    long long throws;
+    long long strikes;
+    long long byPinsDown[NUM_PINS + 1];   // Throws by how many pins fell
+    long long pinFalls[NUM_PINS];         // Throws that felled each pin
+} BowlingStats;
+
+// Monte Carlo over count throws drawn uniformly from distribution. Throw i is drawn from a
+// counter-based generator keyed by (seed, i), so the totals depend only on seed and count,
+// never on the thread count.
+BowlingStats SampleThrows(JobSystem *jobs, const BowlingRules *rules, const BowlingLane *lane,
+                          ThrowDistribution distribution, long long count, unsigned long long seed);
+
+// Assist: the plain throw on an angleSteps x powerSteps grid over the legal range that knocks
+// the most pins; ties go to the straightest, then the softest
+BowlingThrow PlanThrow(JobSystem *jobs, const BowlingRules *rules, const BowlingLane *lane, int angleSteps, int powerSteps);
+
+#endif // BOWLING_H
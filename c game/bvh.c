@@ -0,0 +1,194 @@
+#include "bvh.h"
+#include "sweep.h"
+#include <stdbool.h>
+#include <stdlib.h>
+
+// ------------ Build ------------
+static float CentreOf(const Rectangle *rect, int axis) {
+    return (axis == 0) ? rect->x + rect->width * 0.5f : rect->y + rect->height * 0.5f;
+}
+
+static Rectangle Union(Rectangle a, Rectangle b) {
+    float x0 = (a.x < b.x) ? a.x : b.x, y0 = (a.y < b.y) ? a.y : b.y;
+    float x1 = (a.x + a.width > b.x + b.width) ? a.x + a.width : b.x + b.width;
+    float y1 = (a.y + a.height > b.y + b.height) ? a.y + a.height : b.y + b.height;
+    return (Rectangle){ x0, y0, x1 - x0, y1 - y0 };
+}
+
+// Ties compare by index, so the tree comes out the same for the same input everywhere
+static bool Before(const Rectangle *rects, int a, int b, int axis) {
+    float ka = CentreOf(&rects[a], axis), kb = CentreOf(&rects[b], axis);
+    return (ka < kb) || (ka == kb && a < b);
+}
+
+// Reorders items[begin, end) so the k-th smallest centre sits at k with smaller ones before it
+static void SelectMedian(int *items, const Rectangle *rects, int begin, int end, int k, int axis) {
+    while (end - begin > 1) {
+        int pivot = items[begin + (end - begin) / 2], store = begin;
+        int last = end - 1;
+        int tmp = items[last]; items[last] = pivot; items[begin + (end - begin) / 2] = tmp;
+        for (int i = begin; i < last; i++) {
+            if (Before(rects, items[i], pivot, axis)) {
+                tmp = items[i]; items[i] = items[store]; items[store] = tmp;
+                store++;
+            }
+        }
+        tmp = items[store]; items[store] = items[last]; items[last] = tmp;
+
+        if (k == store) return;
+        if (k < store) end = store;
+        else begin = store + 1;
+    }
+}
+
+static int BuildNode(StaticBvh *bvh, const Rectangle *rects, int begin, int end) {
+    int node = bvh->nodeCount++;
+    Rectangle bounds = rects[bvh->items[begin]];
+    float minX = CentreOf(&bounds, 0), maxX = minX, minY = CentreOf(&bounds, 1), maxY = minY;
+    for (int i = begin + 1; i < end; i++) {
+        const Rectangle *r = &rects[bvh->items[i]];
+        bounds = Union(bounds, *r);
+        float cx = CentreOf(r, 0), cy = CentreOf(r, 1);
+        if (cx < minX) minX = cx;
+        if (cx > maxX) maxX = cx;
+        if (cy < minY) minY = cy;
+        if (cy > maxY) maxY = cy;
+    }
+    bvh->nodes[node].bounds = bounds;
+
+    if (end - begin <= BVH_LEAF_SIZE) {
+        bvh->nodes[node].first = begin;
+        bvh->nodes[node].count = end - begin;
+        return node;
+    }
+
+    int axis = (maxX - minX >= maxY - minY) ? 0 : 1;
+    int middle = begin + (end - begin) / 2;
+    SelectMedian(bvh->items, rects, begin, end, middle, axis);
+
+    BuildNode(bvh, rects, begin, middle);
+    int right = BuildNode(bvh, rects, middle, end);
+    bvh->nodes[node].first = right;
+    bvh->nodes[node].count = 0;
+    return node;
+}
+
+void BuildStaticBvh(StaticBvh *bvh, const Rectangle *rects, int count) {
+    bvh->nodeCount = 0;
+    if (count <= 0) return;
+
+    // Median splits leave at least two rectangles per leaf: at most n/2 leaves, under n nodes
+    int nodesNeeded = count;
+    if (nodesNeeded > bvh->nodeCapacity) {
+        bvh->nodes = realloc(bvh->nodes, nodesNeeded * sizeof(BvhNode));
+        bvh->nodeCapacity = nodesNeeded;
+    }
+    if (count > bvh->itemCapacity) {
+        bvh->items = realloc(bvh->items, count * sizeof(int));
+        bvh->itemCapacity = count;
+    }
+    for (int i = 0; i < count; i++) bvh->items[i] = i;
+    BuildNode(bvh, rects, 0, count);
+}
+
+void UnloadStaticBvh(StaticBvh *bvh) {
+    free(bvh->nodes);
+    free(bvh->items);
+    *bvh = (StaticBvh){ 0 };
+}
+
+// ------------ Queries ------------
+static bool Overlaps(Rectangle a, Rectangle b) {
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+static bool CircleOverlaps(Vector2 center, float radius, Rectangle rect) {
+    float nx = (center.x < rect.x) ? rect.x : (center.x > rect.x + rect.width) ? rect.x + rect.width : center.x;
+    float ny = (center.y < rect.y) ? rect.y : (center.y > rect.y + rect.height) ? rect.y + rect.height : center.y;
+    float dx = center.x - nx, dy = center.y - ny;
+    return dx*dx + dy*dy < radius*radius;
+}
+
+// Walks every leaf whose bounds overlap box; exact tests are left to the callers below
+#define BVH_WALK(bvh, box, leafBody) do {                                              \
+    int stack_[BVH_MAX_DEPTH], top_ = 0;                                               \
+    if ((bvh)->nodeCount > 0) stack_[top_++] = 0;                                      \
+    while (top_ > 0) {                                                                 \
+        const BvhNode *node_ = &(bvh)->nodes[stack_[--top_]];                          \
+        if (!Overlaps(node_->bounds, (box))) continue;                                 \
+        if (node_->count > 0) {                                                        \
+            for (int k_ = node_->first; k_ < node_->first + node_->count; k_++) {      \
+                int index = (bvh)->items[k_];                                          \
+                leafBody                                                               \
+            }                                                                          \
+        } else {                                                                       \
+            stack_[top_++] = node_->first;                                             \
+            stack_[top_++] = (int)(node_ - (bvh)->nodes) + 1;                          \
+        }                                                                              \
+    }                                                                                  \
+} while (0)
+
+int QueryStaticBvh(const StaticBvh *bvh, const Rectangle *rects, Rectangle box, int *results, int maxResults) {
+    int found = 0;
+    BVH_WALK(bvh, box, {
+        if (Overlaps(rects[index], box)) {
+            if (found < maxResults) results[found] = index;
+            found++;
+        }
+    });
+    return found;
+}
+
+int BvhAnyRect(const StaticBvh *bvh, const Rectangle *rects, Rectangle box) {
+    BVH_WALK(bvh, box, {
+        if (Overlaps(rects[index], box)) return index;
+    });
+    return -1;
+}
+
+int BvhAnyCircle(const StaticBvh *bvh, const Rectangle *rects, Vector2 center, float radius) {
+    Rectangle box = { center.x - radius, center.y - radius, 2.0f * radius, 2.0f * radius };
+    BVH_WALK(bvh, box, {
+        if (CircleOverlaps(center, radius, rects[index])) return index;
+    });
+    return -1;
+}
+
+// Bounds of a rectangle over its whole move
+static Rectangle SweptBounds(Rectangle rect, Vector2 delta) {
+    return Union(rect, (Rectangle){ rect.x + delta.x, rect.y + delta.y, rect.width, rect.height });
+}
+
+static void KeepEarliest(float t, int index, float *best, int *hit) {
+    if (t < 0.0f) return;
+    if (*hit < 0 || t < *best || (t == *best && index < *hit)) {
+        *best = t;
+        *hit = index;
+    }
+}
+
+int BvhSweepCircle(const StaticBvh *bvh, const Rectangle *rects, Vector2 from, Vector2 to, float radius, float *time) {
+    Rectangle box = SweptBounds((Rectangle){ from.x - radius, from.y - radius, 2.0f * radius, 2.0f * radius },
+                                (Vector2){ to.x - from.x, to.y - from.y });
+    float best = -1.0f;
+    int hit = -1;
+    BVH_WALK(bvh, box, {
+        KeepEarliest(SweepCircleRect(from, to, radius, rects[index]), index, &best, &hit);
+    });
+    if (time) *time = best;
+    return hit;
+}
+
+int BvhSweepRect(const StaticBvh *bvh, const Rectangle *rects, Rectangle rect, Vector2 delta, float *time) {
+    // The rectangle's centre as a point against every rock grown by the rectangle's half size
+    float hw = rect.width * 0.5f, hh = rect.height * 0.5f;
+    Vector2 from = { rect.x + hw, rect.y + hh }, to = { from.x + delta.x, from.y + delta.y };
+    float best = -1.0f;
+    int hit = -1;
+    BVH_WALK(bvh, SweptBounds(rect, delta), {
+        Rectangle r = rects[index];
+        KeepEarliest(SweepSegmentRect(from, to, (Rectangle){ r.x - hw, r.y - hh, r.width + rect.width, r.height + rect.height }), index, &best, &hit);
+    });
+    if (time) *time = best;
+    return hit;
+}
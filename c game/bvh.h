@@ -0,0 +1,43 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "raylib.h"
+
+#define BVH_LEAF_SIZE  4     // Rectangles per leaf
+#define BVH_MAX_DEPTH  64    // Query stack; median splits keep real trees far shallower
+
+// Nodes in depth-first order: an inner node's left child is the next node
+typedef struct {
+    Rectangle bounds;
+    int first;     // Leaf: first entry in items. Inner: index of the right child.
+    int count;     // Rectangles in a leaf, 0 for inner nodes
+} BvhNode;
+
+// Static AABB tree over a caller-owned rectangle array, built once per map by median splits
+// along the wider axis. Queries take the same array the tree was built from.
+typedef struct {
+    BvhNode *nodes;
+    int     *items;        // Rectangle indices, each leaf owns a run
+    int      nodeCount;
+    int      nodeCapacity;
+    int      itemCapacity;
+} StaticBvh;
+
+void BuildStaticBvh(StaticBvh *bvh, const Rectangle *rects, int count);
+void UnloadStaticBvh(StaticBvh *bvh);
+
+// Indices of rectangles overlapping box, in tree order; returns how many, writing at most maxResults
+int QueryStaticBvh(const StaticBvh *bvh, const Rectangle *rects, Rectangle box, int *results, int maxResults);
+
+// Index of some rectangle overlapping the box or circle, or -1; stops at the first one found
+int BvhAnyRect(const StaticBvh *bvh, const Rectangle *rects, Rectangle box);
+int BvhAnyCircle(const StaticBvh *bvh, const Rectangle *rects, Vector2 center, float radius);
+
+// Index of the rectangle a circle moving from `from` to `to` reaches first, or -1, with the
+// time as a fraction of the move (see sweep.h) in *time. Ties go to the lowest index.
+int BvhSweepCircle(const StaticBvh *bvh, const Rectangle *rects, Vector2 from, Vector2 to, float radius, float *time);
+
+// The same for a rectangle moved by delta
+int BvhSweepRect(const StaticBvh *bvh, const Rectangle *rects, Rectangle rect, Vector2 delta, float *time);
+
+#endif // BVH_H
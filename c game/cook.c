@@ -0,0 +1,95 @@
+/*******************************************************************************************
+*
+*   Asset cooker: decodes every game PNG once at build time, applies its recipe (resize,
+*   RGBA8 conversion) and writes the raw pixels plus an index to resources/assets.pack.
+*
+*   Usage: cook [pack=resources/assets.pack]
+*          cook bench [runs=20]
+*
+*   The game maps the pack and uploads textures straight from the mapped bytes, so startup
+*   does no PNG decode, no resize and no per-file open/read.
+*
+*   The bench mode times the CPU side of loading every image both ways: decoding the PNGs
+*   the way the game used to, and mapping the pack and touching every pixel page. GPU upload
+*   is the same in both cases and needs a window, so it is left out.
+*
+********************************************************************************************/
+
+#include "raylib.h"
+#include "assets.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int Cook(const char *fileName) {
+    Image images[ASSET_COUNT] = { 0 };
+    size_t bytes = 0;
+    int cooked = 0;
+
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        images[i] = CookImage((AssetId)i);
+        if (images[i].data == NULL) continue;
+        cooked++;
+        bytes += (size_t)GetPixelDataSize(images[i].width, images[i].height, images[i].format);
+        printf("%-12s %4dx%-4d\n", assetRecipes[i].name, images[i].width, images[i].height);
+    }
+
+    bool ok = WriteAssetPack(fileName, images, ASSET_COUNT);
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        if (images[i].data != NULL) UnloadImage(images[i]);
+    }
+
+    if (!ok) {
+        fprintf(stderr, "cook: could not write %s\n", fileName);
+        return 1;
+    }
+    printf("wrote %s: %d images, %.1f KB of pixels\n", fileName, cooked, bytes / 1024.0);
+    return 0;
+}
+
+static int Bench(int runs) {
+    if (runs < 1) runs = 1;
+    double decode = 0.0, mapped = 0.0;
+    volatile unsigned int sink = 0;
+
+    for (int r = 0; r < runs; r++) {
+        // What startup used to do for each image
+        double start = NowSeconds();
+        for (int i = 0; i < ASSET_COUNT; i++) {
+            Image image = CookImage((AssetId)i);
+            if (image.data != NULL) UnloadImage(image);
+        }
+        decode += NowSeconds() - start;
+
+        // Map once, then fault in every pixel page as the texture upload would
+        start = NowSeconds();
+        AssetPack pack;
+        if (!OpenAssetPack(&pack, ASSET_PACK_FILE)) {
+            fprintf(stderr, "cook: no %s, run cook first\n", ASSET_PACK_FILE);
+            return 1;
+        }
+        for (int i = 0; i < ASSET_COUNT; i++) {
+            Image image = GetPackedImage(&pack, (AssetId)i);
+            if (image.data == NULL) continue;
+            const unsigned char *pixels = image.data;
+            int size = GetPixelDataSize(image.width, image.height, image.format);
+            for (int b = 0; b < size; b += 4096) sink += pixels[b];
+        }
+        CloseAssetPack(&pack);
+        mapped += NowSeconds() - start;
+    }
+
+    printf("runs: %d\n", runs);
+    printf("png decode + resize: %8.3f ms per startup\n", 1000.0 * decode / runs);
+    printf("mapped pack:         %8.3f ms per startup (%.0fx faster)\n",
+           1000.0 * mapped / runs, mapped > 0.0 ? decode / mapped : 0.0);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    SetTraceLogLevel(LOG_WARNING);
+
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) return Bench((argc > 2) ? atoi(argv[2]) : 20);
+    return Cook((argc > 1) ? argv[1] : ASSET_PACK_FILE);
+}
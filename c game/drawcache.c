@@ -0,0 +1,165 @@
+#include "drawcache.h"
+#include "rlgl.h"
+#include <math.h>
+#include <string.h>
+
+unsigned int LayerKey(unsigned int key, const void *bytes, int size) {
+    const unsigned char *p = bytes;
+    for (int i = 0; i < size; i++) key = (key ^ p[i]) * 16777619u;
+    return key;
+}
+
+// Render textures come out upside down; a negative source height flips them back
+static void DrawTarget(RenderTexture2D target, Vector2 position, float width, float height, Color tint) {
+    DrawTextureRec(target.texture, (Rectangle){ 0, 0, width, -height }, position, tint);
+}
+
+// ------------ Cached layers ------------
+bool BeginCachedLayer(CachedLayer *layer, int width, int height, unsigned int key, Color clear) {
+    if (layer->valid && layer->key == key && layer->width == width && layer->height == height) return false;
+
+    if (layer->target.id == 0 || layer->width != width || layer->height != height) {
+        if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+        layer->target = LoadRenderTexture(width, height);
+        layer->width = width;
+        layer->height = height;
+    }
+    layer->key = key;
+    layer->valid = true;
+    layer->rebuilds++;
+
+    // Plain alpha blending would also scale the target's alpha by the source's, leaving the
+    // edges of whatever is drawn see-through once the layer lands on the screen
+    BeginTextureMode(layer->target);
+    ClearBackground(clear);
+    rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    return true;
+}
+
+void EndCachedLayer(CachedLayer *layer) {
+    EndBlendMode();
+    EndTextureMode();
+}
+
+void DrawCachedLayer(const CachedLayer *layer) {
+    if (layer->target.id != 0) DrawTarget(layer->target, (Vector2){ 0, 0 }, (float)layer->width, (float)layer->height, WHITE);
+}
+
+void InvalidateCachedLayer(CachedLayer *layer) {
+    layer->valid = false;
+}
+
+void UnloadCachedLayer(CachedLayer *layer) {
+    if (layer->target.id != 0) UnloadRenderTexture(layer->target);
+    *layer = (CachedLayer){ 0 };
+}
+
+// ------------ Text cache ------------
+void InitTextCache(TextCache *cache) {
+    memset(cache, 0, sizeof(*cache));
+}
+
+void UnloadTextCache(TextCache *cache) {
+    for (int i = 0; i < TEXT_CACHE_ENTRIES; i++) {
+        if (cache->entries[i].target.id != 0) UnloadRenderTexture(cache->entries[i].target);
+    }
+    memset(cache, 0, sizeof(*cache));
+}
+
+static bool SameColor(Color a, Color b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+static CachedText *FindText(TextCache *cache, unsigned int hash, unsigned int fontId, const char *text, float fontSize, float spacing, Color tint) {
+    for (int i = 0; i < TEXT_CACHE_ENTRIES; i++) {
+        CachedText *entry = &cache->entries[i];
+        if (!entry->used || entry->hash != hash || entry->fontId != fontId) continue;
+        if (entry->fontSize != fontSize || entry->spacing != spacing || !SameColor(entry->tint, tint)) continue;
+        if (strcmp(entry->text, text) == 0) return entry;
+    }
+    return NULL;
+}
+
+// An unused entry, or else the one drawn longest ago
+static CachedText *FreeEntry(TextCache *cache) {
+    CachedText *oldest = &cache->entries[0];
+    for (int i = 0; i < TEXT_CACHE_ENTRIES; i++) {
+        CachedText *entry = &cache->entries[i];
+        if (!entry->used) return entry;
+        if (entry->lastUsed < oldest->lastUsed) oldest = entry;
+    }
+    cache->stats.evictions++;
+    return oldest;
+}
+
+// Lays the string out once into its own texture. The glyphs are added onto a blank target so
+// their alpha is kept as is rather than blended against nothing.
+static void RenderText(CachedText *entry) {
+    Font font = entry->font;
+    entry->size = MeasureTextEx(font, entry->text, entry->fontSize, entry->spacing);
+    int width = (int)ceilf(entry->size.x) + 1, height = (int)ceilf(entry->size.y) + 1;
+
+    if (entry->target.id == 0 || entry->target.texture.width != width || entry->target.texture.height != height) {
+        if (entry->target.id != 0) UnloadRenderTexture(entry->target);
+        entry->target = LoadRenderTexture(width, height);
+    }
+    if (entry->target.id == 0) return;
+
+    BeginTextureMode(entry->target);
+    ClearBackground(BLANK);
+    BeginBlendMode(BLEND_ADD_COLORS);
+    DrawTextEx(font, entry->text, (Vector2){ 0, 0 }, entry->fontSize, entry->spacing, entry->tint);
+    EndBlendMode();
+    EndTextureMode();
+}
+
+void DrawCachedText(TextCache *cache, Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint) {
+    cache->clock++;
+    int length = (int)strlen(text);
+    if (length >= TEXT_CACHE_LENGTH) {
+        cache->stats.misses++;
+        DrawTextEx(font, text, position, fontSize, spacing, tint);
+        return;
+    }
+
+    unsigned int hash = LayerKey(LAYER_KEY_SEED, text, length);
+    CachedText *entry = FindText(cache, hash, font.texture.id, text, fontSize, spacing, tint);
+    if (entry == NULL) {
+        entry = FreeEntry(cache);
+        entry->used = true;
+        entry->pending = true;
+        entry->hash = hash;
+        entry->fontId = font.texture.id;
+        entry->font = font;
+        entry->fontSize = fontSize;
+        entry->spacing = spacing;
+        entry->tint = tint;
+        memcpy(entry->text, text, length + 1);
+    }
+    entry->lastUsed = cache->clock;
+
+    if (!entry->pending && entry->target.id != 0) {
+        cache->stats.hits++;
+        DrawTarget(entry->target, position, (float)entry->target.texture.width, (float)entry->target.texture.height, WHITE);
+    } else {
+        cache->stats.misses++;
+        DrawTextEx(font, text, position, fontSize, spacing, tint);
+    }
+}
+
+void BuildPendingText(TextCache *cache) {
+    for (int i = 0; i < TEXT_CACHE_ENTRIES; i++) {
+        CachedText *entry = &cache->entries[i];
+        if (!entry->pending) continue;
+        RenderText(entry);
+        entry->pending = false;
+        entry->font = (Font){ 0 };
+    }
+}
+
+void LogTextCache(const TextCache *cache) {
+    long long draws = cache->stats.hits + cache->stats.misses;
+    TraceLog(LOG_INFO, "TEXT: %lld draws, %lld hits (%.1f%%), %lld misses, %d evictions", draws, cache->stats.hits,
+             (draws > 0) ? 100.0 * (double)cache->stats.hits / (double)draws : 0.0, cache->stats.misses, cache->stats.evictions);
+}
@@ -0,0 +1,79 @@
+#ifndef DRAWCACHE_H
+#define DRAWCACHE_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+#define TEXT_CACHE_ENTRIES  32    // Strings kept rendered at once; the least recently drawn goes first
+#define TEXT_CACHE_LENGTH   64    // Longer strings are drawn directly and counted as misses
+
+// ------------ Cached layers ------------
+// A static part of a scene rendered once into a texture and redrawn with one quad. The caller
+// sums up everything the layer depends on in a key; the layer is re-rendered only when that
+// key or the screen size changes.
+typedef struct {
+    RenderTexture2D target;   // id 0 until first built
+    int          width;
+    int          height;
+    unsigned int key;
+    bool         valid;
+    int          rebuilds;
+} CachedLayer;
+
+// FNV-1a of bytes, folded into key; start from LAYER_KEY_SEED
+#define LAYER_KEY_SEED  2166136261u
+unsigned int LayerKey(unsigned int key, const void *bytes, int size);
+
+// True when the layer is stale: the caller then draws its content and calls EndCachedLayer().
+// Drawing goes into the layer's texture, cleared to clear, in screen coordinates.
+bool BeginCachedLayer(CachedLayer *layer, int width, int height, unsigned int key, Color clear);
+void EndCachedLayer(CachedLayer *layer);
+void DrawCachedLayer(const CachedLayer *layer);
+void InvalidateCachedLayer(CachedLayer *layer);
+void UnloadCachedLayer(CachedLayer *layer);
+
+// ------------ Text cache ------------
+typedef struct {
+    long long hits;           // Draws served from an already rendered string
+    long long misses;         // Draws that had to lay the string out
+    int evictions;
+} TextCacheStats;
+
+// One string rendered in its colour; keyed by the font's texture, the text, size, spacing and tint
+typedef struct {
+    unsigned int hash;        // FNV-1a of the text, checked before the full compare
+    unsigned int fontId;
+    float        fontSize;
+    float        spacing;
+    Color        tint;
+    char         text[TEXT_CACHE_LENGTH];
+    RenderTexture2D target;
+    Vector2      size;        // Measured size; the texture is rounded up from it
+    Font         font;        // Kept until the queued string is rendered
+    unsigned long long lastUsed;
+    bool         used;
+    bool         pending;     // Queued; drawn directly until BuildPendingText()
+} CachedText;
+
+typedef struct {
+    CachedText entries[TEXT_CACHE_ENTRIES];
+    unsigned long long clock; // Bumped per draw; orders entries for eviction
+    TextCacheStats stats;
+} TextCache;
+
+void InitTextCache(TextCache *cache);
+void UnloadTextCache(TextCache *cache);
+
+// DrawTextEx() through the cache: the glyphs are laid out once per distinct string and later
+// draws of it are a single textured quad. A miss draws directly and queues the string, so
+// this is safe inside any texture mode.
+void DrawCachedText(TextCache *cache, Font font, const char *text, Vector2 position, float fontSize, float spacing, Color tint);
+
+// Renders the queued strings into their textures; outside any texture mode, before the fonts
+// drawn with this frame can be unloaded
+void BuildPendingText(TextCache *cache);
+
+// Logs the counters
+void LogTextCache(const TextCache *cache);
+
+#endif // DRAWCACHE_H
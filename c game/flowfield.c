@@ -0,0 +1,208 @@
+#include "flowfield.h"
+#include <math.h>
+#include <stdlib.h>
+
+#define FLOW_UNVISITED  (FLOW_UNREACHED - 1)   // Open cell the search has not reached yet
+#define FLOW_STRAIGHT   5
+#define FLOW_DIAGONAL   7
+#define FLOW_BUCKETS    8                      // Above the dearest step, so pending costs never share a bucket
+
+// Straight neighbours first, so ties between equally cheap steps go the same way every build
+static const int neighbourX[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int neighbourY[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+void InitFlowField(FlowField *field, float cellSize) {
+    *field = (FlowField){ 0 };
+    field->cellSize = cellSize;
+    field->invCellSize = 1.0f / cellSize;
+    field->targetCell = -1;
+}
+
+void UnloadFlowField(FlowField *field) {
+    free(field->distance);
+    free(field->next);
+    free(field->prev);
+    free(field->dirX);
+    free(field->dirY);
+    InitFlowField(field, field->cellSize);
+}
+
+// ------------ Build ------------
+static void ResizeFlowField(FlowField *field, float width, float height) {
+    field->width = width;
+    field->height = height;
+    field->cols = (int)ceilf(width * field->invCellSize);
+    field->rows = (int)ceilf(height * field->invCellSize);
+    if (field->cols < 1) field->cols = 1;
+    if (field->rows < 1) field->rows = 1;
+
+    int padded = (field->cols + 2) * (field->rows + 2);
+    if (padded <= field->cellCapacity) return;
+    field->distance = realloc(field->distance, padded * sizeof(int));
+    field->next = realloc(field->next, padded * sizeof(int));
+    field->prev = realloc(field->prev, padded * sizeof(int));
+    field->dirX = realloc(field->dirX, padded * sizeof(float));
+    field->dirY = realloc(field->dirY, padded * sizeof(float));
+    field->cellCapacity = padded;
+}
+
+static int CellAt(const FlowField *field, Vector2 position) {
+    int cx = (int)floorf(position.x * field->invCellSize);
+    int cy = (int)floorf(position.y * field->invCellSize);
+    cx = (cx < 0) ? 0 : (cx >= field->cols) ? field->cols - 1 : cx;
+    cy = (cy < 0) ? 0 : (cy >= field->rows) ? field->rows - 1 : cy;
+    return cy * field->cols + cx;
+}
+
+// Cells whose centre lies inside the obstacle grown by clearance
+static void BlockObstacle(FlowField *field, Rectangle rect, float clearance) {
+    float left = (rect.x - clearance) * field->invCellSize - 0.5f;
+    float top = (rect.y - clearance) * field->invCellSize - 0.5f;
+    float right = (rect.x + rect.width + clearance) * field->invCellSize - 0.5f;
+    float bottom = (rect.y + rect.height + clearance) * field->invCellSize - 0.5f;
+
+    int x0 = (int)ceilf(left), y0 = (int)ceilf(top), x1 = (int)floorf(right), y1 = (int)floorf(bottom);
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= field->cols) x1 = field->cols - 1;
+    if (y1 >= field->rows) y1 = field->rows - 1;
+
+    int stride = field->cols + 2;
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) field->distance[(y + 1) * stride + (x + 1)] = FLOW_UNREACHED;
+    }
+}
+
+static void BucketInsert(FlowField *field, int *heads, int cell, int bucket) {
+    field->next[cell] = heads[bucket];
+    field->prev[cell] = -1;
+    if (heads[bucket] >= 0) field->prev[heads[bucket]] = cell;
+    heads[bucket] = cell;
+}
+
+static void BucketRemove(FlowField *field, int *heads, int cell, int bucket) {
+    if (field->prev[cell] >= 0) field->next[field->prev[cell]] = field->next[cell];
+    else heads[bucket] = field->next[cell];
+    if (field->next[cell] >= 0) field->prev[field->next[cell]] = field->prev[cell];
+}
+
+static void BuildFlowField(FlowField *field, const Rectangle *obstacles, int obstacleCount, float clearance) {
+    int cols = field->cols, rows = field->rows, stride = cols + 2;
+    int *distance = field->distance;
+
+    // Border cells stay blocked, so neighbour lookups need no bounds checks
+    for (int y = 0; y < rows + 2; y++) {
+        for (int x = 0; x < stride; x++) {
+            bool border = (x == 0 || y == 0 || x == stride - 1 || y == rows + 1);
+            distance[y * stride + x] = border ? FLOW_UNREACHED : FLOW_UNVISITED;
+        }
+    }
+    for (int i = 0; i < obstacleCount; i++) BlockObstacle(field, obstacles[i], clearance);
+
+    int offsets[8];
+    for (int k = 0; k < 8; k++) offsets[k] = neighbourY[k] * stride + neighbourX[k];
+
+    // A target inside a rock still gets a field; the agents just stop short of it
+    int heads[FLOW_BUCKETS];
+    for (int b = 0; b < FLOW_BUCKETS; b++) heads[b] = -1;
+    int target = (field->targetCell / cols + 1) * stride + (field->targetCell % cols + 1);
+    distance[target] = 0;
+    BucketInsert(field, heads, target, 0);
+
+    // Every pending cost lies within one step of the current one, so bucket d % 8 holds exactly d
+    for (int d = 0, pending = 1; pending > 0; d++) {
+        int bucket = d % FLOW_BUCKETS;
+        while (heads[bucket] >= 0) {
+            int cell = heads[bucket];
+            BucketRemove(field, heads, cell, bucket);
+            pending--;
+
+            for (int k = 0; k < 8; k++) {
+                int n = cell + offsets[k];
+                if (distance[n] == FLOW_UNREACHED) continue;
+                if (k >= 4 && (distance[cell + neighbourX[k]] == FLOW_UNREACHED || distance[cell + neighbourY[k] * stride] == FLOW_UNREACHED)) continue;
+
+                int nd = d + ((k < 4) ? FLOW_STRAIGHT : FLOW_DIAGONAL);
+                if (nd >= distance[n]) continue;
+                if (distance[n] == FLOW_UNVISITED) pending++;
+                else BucketRemove(field, heads, n, distance[n] % FLOW_BUCKETS);
+                distance[n] = nd;
+                BucketInsert(field, heads, n, nd % FLOW_BUCKETS);
+            }
+        }
+    }
+
+    // Each open cell points at its cheapest neighbour; a diagonal may not clip a blocked corner
+    const float diagonal = 0.70710678f;
+    for (int y = 0; y < rows; y++) {
+        for (int x = 0; x < cols; x++) {
+            int cell = (y + 1) * stride + (x + 1), out = y * cols + x;
+            field->dirX[out] = 0.0f;
+            field->dirY[out] = 0.0f;
+            if (distance[cell] == FLOW_UNVISITED) distance[cell] = FLOW_UNREACHED;
+            if (distance[cell] == FLOW_UNREACHED || cell == target) continue;
+
+            int best = -1, bestDistance = distance[cell];
+            for (int k = 0; k < 8; k++) {
+                int d = distance[cell + offsets[k]];
+                if (d >= bestDistance) continue;   // Also skips blocked and unreached cells
+                if (k >= 4 && (distance[cell + neighbourX[k]] >= FLOW_UNVISITED || distance[cell + neighbourY[k] * stride] >= FLOW_UNVISITED)) continue;
+                best = k;
+                bestDistance = d;
+            }
+            if (best < 0) continue;
+            float scale = (best < 4) ? 1.0f : diagonal;
+            field->dirX[out] = neighbourX[best] * scale;
+            field->dirY[out] = neighbourY[best] * scale;
+        }
+    }
+}
+
+bool UpdateFlowField(FlowField *field, float width, float height, const Rectangle *obstacles, int obstacleCount,
+                     float clearance, unsigned int obstacleVersion, Vector2 target) {
+    bool resized = (width != field->width || height != field->height || field->cols == 0);
+    if (resized) ResizeFlowField(field, width, height);
+
+    int targetCell = CellAt(field, target);
+    if (!resized && targetCell == field->targetCell && obstacleVersion == field->obstacleVersion) return false;
+
+    field->targetCell = targetCell;
+    field->obstacleVersion = obstacleVersion;
+    BuildFlowField(field, obstacles, obstacleCount, clearance);
+    field->rebuilds++;
+    return true;
+}
+
+// ------------ Steering ------------
+void SteerEnemiesFlow(const FlowField *field, float *x, float *y, float *vx, float *vy, const float *speed, int count, Vector2 target, float dt) {
+    const float inv = field->invCellSize;
+    const int cols = field->cols, rows = field->rows;
+
+    for (int i = 0; i < count; i++) {
+        // Truncation only equals floor for x, y >= 0, which the range test needs anyway
+        float gx = x[i] * inv, gy = y[i] * inv;
+        float dirX = 0.0f, dirY = 0.0f;
+        if (gx >= 0.0f && gy >= 0.0f && gx < (float)cols && gy < (float)rows) {
+            int cell = (int)gy * cols + (int)gx;
+            dirX = field->dirX[cell];
+            dirY = field->dirY[cell];
+        }
+
+        if (dirX != 0.0f || dirY != 0.0f) {
+            vx[i] = dirX * speed[i];
+            vy[i] = dirY * speed[i];
+        } else {
+            // Same arithmetic as the homing kernel
+            float dx = target.x - x[i];
+            float dy = target.y - y[i];
+            float d2 = dx*dx + dy*dy;
+            if (d2 > 0.0f) {
+                float invLength = 1.0f / sqrtf(d2);
+                vx[i] = (dx * invLength) * speed[i];
+                vy[i] = (dy * invLength) * speed[i];
+            }
+        }
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+}
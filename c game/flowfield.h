@@ -0,0 +1,46 @@
+#ifndef FLOWFIELD_H
+#define FLOWFIELD_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+#define FLOW_UNREACHED  0x7FFFFFFF   // Distance of blocked cells and cells walled off from the target
+
+// Grid flow field over the playfield: a Dijkstra pass from the target's cell around the
+// obstacles (grown by the agents' radius) gives every open cell the direction of its
+// cheapest neighbour, so any number of agents find their way around rocks with one lookup
+// each. Steps cost 5 straight and 7 diagonal; with integer costs that small the search runs
+// on a ring of 8 buckets instead of a heap, and the field is the same on every machine.
+typedef struct {
+    float cellSize;
+    float invCellSize;
+    int   cols, rows;
+
+    // What the current field was built for; UpdateFlowField() skips the rebuild while it holds
+    float width, height;
+    int   targetCell;              // -1 before the first build
+    unsigned int obstacleVersion;
+
+    // Search state over a grid padded by one blocked cell on every side, (cols + 2) x (rows + 2)
+    int   *distance;               // Path cost to the target cell
+    int   *next, *prev;            // Bucket queue links
+    float *dirX, *dirY;            // Per unpadded cell, unit step toward the target; zero in the target cell and unreachable cells
+    int   cellCapacity;
+
+    int   rebuilds;
+} FlowField;
+
+void InitFlowField(FlowField *field, float cellSize);
+void UnloadFlowField(FlowField *field);
+
+// Rebuilds the field when the target has moved to another cell, the playfield was resized or
+// obstacleVersion differs from the last build; returns whether it did. obstacles are kept
+// clearance away from every path.
+bool UpdateFlowField(FlowField *field, float width, float height, const Rectangle *obstacles, int obstacleCount,
+                     float clearance, unsigned int obstacleVersion, Vector2 target);
+
+// Same contract as SteerEnemies(), but agents follow the field. Agents in the target's cell,
+// in a blocked or unreachable cell or off the grid home straight in on target as before.
+void SteerEnemiesFlow(const FlowField *field, float *x, float *y, float *vx, float *vy, const float *speed, int count, Vector2 target, float dt);
+
+#endif // FLOWFIELD_H
@@ -0,0 +1,1469 @@
+/*******************************************************************************************
+*
+*   Headless driver for the simulation core: no window, audio device or GPU.
+*
+*   Usage: headless [ticks] [easy|medium|hard]
+*          headless stress [maxBullets]
+*          headless steer [enemies]
+*          headless batch [ticks]
+*          headless record file [ticks] [easy|medium|hard]
+*          headless replay file [threads]
+*          headless scale [enemies] [maxThreads]
+*          headless threaded file [seconds] [easy|medium|hard]
+*          headless flow [enemies]
+*          headless obstacles [rocks]
+*          headless patterns [emitters]
+*          headless bowling [throws]
+*          headless sweep [cases]
+*          headless resolution [frames]
+*          headless rollback [ticks]
+*          headless random [values]
+*
+*   A scripted bot plays GAMEPLAY and MINI_GAME at a fixed 60 Hz step, restarting the run
+*   whenever it ends, and the tool prints how many ticks per second the core sustains.
+*
+*   The stress mode times the enemy-vs-bullet collision pass alone, broadphase against the
+*   old all-pairs scan, at constant density from 1k up to maxBullets bullets (default 100k).
+*   It fails if the two find different kills wherever the scan is timed.
+*
+*   The steer mode checks the SIMD homing kernel against the scalar path and times one frame
+*   of it for a swarm of the given size (default 1M) against the 16 ms frame budget.
+*
+*   The batch mode plays Easy (the biggest swarms) and builds the GAMEPLAY sprite batch every
+*   tick against a 800x600 view, reporting draw calls and vertices without a display.
+*
+*   The record mode writes a bot session to a replay file, with uneven frame times like a real
+*   window produces. The replay mode feeds any recording (including ones from the game's
+*   --record flag) back through the core, checks every stored state hash and exits non-zero on
+*   a desync, so a session can be re-run exactly and profiled. Give it a thread count to check
+*   that the parallel passes reproduce a recording made on any other.
+*
+*   The scale mode runs a godMode swarm (default 100k) under a bullet storm on the job system
+*   with 1, 2, 4... threads up to the CPU count, reports ns/tick and speedup, and fails if any
+*   thread count ends on a different state hash than the single-threaded run.
+*
+*   The threaded mode runs the simulation thread the way the game does, against a render loop
+*   at 144 Hz that sends scripted input and stalls now and then like a late vsync. It reports
+*   the step rate the simulation held, the longest the render side spent in a queue or snapshot
+*   call, and any snapshot that went back in time, then replays the recording it made.
+*
+*   The flow mode times Hard's flow-field rebuild at several grid resolutions and the per-tick
+*   cost of following it against plain homing for swarms up to the given size (default 1M).
+*   It then walks a swarm in from the edges both ways and fails if any flow follower ends up
+*   inside a rock.
+*
+*   The obstacles mode places a map of the given number of rocks (default 5000), times the
+*   placement, the tree build and player/enemy/bullet queries against a linear scan, and fails
+*   if two rocks overlap, a rock lands in the player's clearance or the tree disagrees with the
+*   scan. It also places the game's own four-rock map many times around random player spots.
+*
+*   The patterns mode checks the SIMD bullet integrate-and-cull kernel against the scalar path,
+*   then runs a world on one core with the given number of "storm" emitters (default 8, over
+*   50k live bullets) and reports the step cost against the 16 ms frame budget. It fails if the
+*   paths differ or the bullet store grows once the storm has filled up.
+*
+*   The bowling mode plays thousands of throws through the MINI_GAME and fails if the batch
+*   evaluator disagrees with any of them. It then samples the given number of random throws
+*   (default 10M) on 1, 2, 4... threads, reporting throws per second and failing if the totals
+*   depend on the thread count, times full racks of pin physics, sweeps baseSpeed and the
+*   strike rule, and runs the assist.
+*
+*   The sweep mode checks the swept circle and rectangle tests against fine stepping of the
+*   same moves, and the rock tree's earliest hit against a scan. It then fires fast bullets at
+*   still enemies and rushes the player with an enemy that jumps clear over them every tick,
+*   at 60 Hz down to 5 Hz, and fails if anything gets through.
+*
+*   The resolution mode drives the dynamic resolution controller with frame times from a model
+*   display: capped at 60 Hz, with a fixed CPU cost and a GPU cost that scales with the pixels
+*   drawn. It runs a light, a heavy and a light load again for the given number of frames each
+*   (default 3600), reports where the render scale settled and how many frames ran over budget,
+*   and fails if the scale does not settle on the highest one each load allows.
+*
+*   The rollback mode plays Hard runs twice from the same seed: the bot plays a reference world
+*   on time, and a rollback world hears each of its inputs 1, 2, 4 or 8 ticks late, stepping
+*   ahead on predictions and resimulating when one was wrong. Any full rack is a strike, so the
+*   second chance resumes each run. A second set of runs walks straight into a rock. It fails if
+*   the rollback world's state at any confirmed tick differs from the reference, no run resumed,
+*   a run resumed on a rock or one that ended on a rock ended again the tick after it resumed.
+*   It then feeds restore checkpoints cut short or padded, failing if one is taken or the world
+*   changes, and times checkpoint save and restore.
+*
+*   The random mode checks the vector fills of the random streams against single draws and
+*   times both against raylib's GetRandomValue() for the given number of values (default 10M).
+*   It fails if the fills differ, the draws are visibly non-uniform, a spawn burst lands
+*   elsewhere than single spawns, drawing from one stream shifts another's values, two seeds
+*   and ids share a key, or two worlds end differently when stepped in turn rather than one
+*   after the other.
+*
+********************************************************************************************/
+
+#include "world.h"
+#include "raymath.h"
+#include "spatial.h"
+#include "steer.h"
+#include "batch.h"
+#include "render.h"
+#include "timing.h"
+#include "replay.h"
+#include "bot.h"
+#include "jobs.h"
+#include "sim.h"
+#include "flowfield.h"
+#include "obstacles.h"
+#include "bowling.h"
+#include "sweep.h"
+#include "viewport.h"
+#include "rollback.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+static Difficulty ParseDifficulty(const char *name) {
+    if (strcmp(name, "easy") == 0) return DIFFICULTY_EASY;
+    if (strcmp(name, "hard") == 0) return DIFFICULTY_HARD;
+    return DIFFICULTY_MEDIUM;
+}
+
+static float RandomUnit(void) {
+    return (float)rand() / (float)RAND_MAX;
+}
+
+// One collision pass: every enemy takes the lowest-indexed bullet it overlaps
+static int CollideBroadphase(SpatialHash *hash, const Vector2 *enemies, int enemyCount,
+                             const Vector2 *bullets, bool *alive, int bulletCount, int *candidates) {
+    BeginSpatialHash(hash, bulletCount);
+    for (int j = 0; j < bulletCount; j++) SpatialHashInsert(hash, j, bullets[j]);
+    EndSpatialHash(hash);
+
+    int kills = 0;
+    for (int i = 0; i < enemyCount; i++) {
+        int count = QuerySpatialHash(hash, enemies[i], 25.0f, candidates, bulletCount);
+        int hit = -1;
+        for (int k = 0; k < count; k++) {
+            int j = candidates[k];
+            if ((hit < 0 || j < hit) && alive[j] && CheckCollisionCircles(enemies[i], 20, bullets[j], 5)) hit = j;
+        }
+        if (hit >= 0) { alive[hit] = false; kills++; }
+    }
+    return kills;
+}
+
+static int CollideAllPairs(const Vector2 *enemies, int enemyCount, const Vector2 *bullets, bool *alive, int bulletCount) {
+    int kills = 0;
+    for (int i = 0; i < enemyCount; i++) {
+        for (int j = 0; j < bulletCount; j++) {
+            if (alive[j] && CheckCollisionCircles(enemies[i], 20, bullets[j], 5)) {
+                alive[j] = false;
+                kills++;
+                break;
+            }
+        }
+    }
+    return kills;
+}
+
+static int RunStress(int maxBullets) {
+    Vector2 *bullets = malloc(maxBullets * sizeof(Vector2));
+    Vector2 *enemies = malloc(maxBullets * sizeof(Vector2));
+    bool *alive = malloc(maxBullets * sizeof(bool));
+    int *candidates = malloc(maxBullets * sizeof(int));
+
+    SpatialHash hash;
+    InitSpatialHash(&hash, 32.0f);
+
+    printf("%10s %10s %14s %14s %12s %8s\n", "bullets", "enemies", "hash ns/pass", "pairs ns/pass", "ns/bullet", "kills");
+    int wrong = 0;
+
+    static const int sizes[] = { 1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000 };
+    for (int s = 0; s < (int)(sizeof(sizes)/sizeof(sizes[0])) && sizes[s] <= maxBullets; s++) {
+        int n = sizes[s];
+
+        // Area grows with the bullet count so density stays at the game's busiest levels
+        int enemyCount = n / 4;
+        float side = sqrtf((float)n * 400.0f);
+        srand(1234);
+        for (int j = 0; j < n; j++) bullets[j] = (Vector2){ RandomUnit() * side, RandomUnit() * side };
+        for (int i = 0; i < enemyCount; i++) enemies[i] = (Vector2){ RandomUnit() * side, RandomUnit() * side };
+
+        int passes = (n <= 10000) ? 200 : 20;
+        int kills = 0;
+
+        double start = NowSeconds();
+        for (int p = 0; p < passes; p++) {
+            memset(alive, 1, n * sizeof(bool));
+            kills = CollideBroadphase(&hash, enemies, enemyCount, bullets, alive, n, candidates);
+        }
+        double hashNs = (NowSeconds() - start) * 1e9 / passes;
+
+        // The all-pairs scan is only timed while it still finishes in reasonable time
+        double pairsNs = 0.0;
+        if (n <= 10000) {
+            int pairPasses = (n <= 1000) ? 50 : 2;
+            start = NowSeconds();
+            for (int p = 0; p < pairPasses; p++) {
+                memset(alive, 1, n * sizeof(bool));
+                int pairKills = CollideAllPairs(enemies, enemyCount, bullets, alive, n);
+                if (pairKills == kills) continue;
+                printf("MISMATCH: broadphase found %d kills, all-pairs %d\n", kills, pairKills);
+                wrong++;
+            }
+            pairsNs = (NowSeconds() - start) * 1e9 / pairPasses;
+        }
+
+        printf("%10d %10d %14.0f %14.0f %12.1f %8d\n", n, enemyCount, hashNs, pairsNs, hashNs / n, kills);
+    }
+
+    UnloadSpatialHash(&hash);
+    free(candidates);
+    free(alive);
+    free(enemies);
+    free(bullets);
+    return (wrong == 0) ? 0 : 1;
+}
+
+static int RunSteer(int count) {
+    const int frames = 60;
+    const float dt = 1.0f / 60.0f;
+    const float tolerance = 1e-3f;   // Pixels; every path should in fact match bit for bit
+
+    float *data = malloc(10 * (size_t)count * sizeof(float));
+    float *x = data, *y = x + count, *vx = y + count, *vy = vx + count, *speed = vy + count;
+    float *rx = speed + count, *ry = rx + count, *rvx = ry + count, *rvy = rvx + count;
+
+    srand(4321);
+    for (int i = 0; i < count; i++) {
+        x[i] = RandomUnit() * 4000.0f - 1600.0f;
+        y[i] = RandomUnit() * 3000.0f - 1200.0f;
+        vx[i] = vy[i] = 0.0f;
+        speed[i] = 50.0f + 50.0f * RandomUnit();
+    }
+    memcpy(rx, x, count * sizeof(float));
+    memcpy(ry, y, count * sizeof(float));
+    memcpy(rvx, vx, count * sizeof(float));
+    memcpy(rvy, vy, count * sizeof(float));
+
+    // The target wanders so the kernel sees fresh directions every frame
+    double simdTime = 0.0, scalarTime = 0.0, worstFrame = 0.0;
+    for (int f = 0; f < frames; f++) {
+        Vector2 target = { 400.0f + 100.0f * sinf(f * 0.1f), 300.0f + 100.0f * cosf(f * 0.1f) };
+
+        double start = NowSeconds();
+        SteerEnemies(x, y, vx, vy, speed, count, target, dt);
+        double frameTime = NowSeconds() - start;
+        simdTime += frameTime;
+        if (frameTime > worstFrame) worstFrame = frameTime;
+
+        start = NowSeconds();
+        SteerEnemiesScalar(rx, ry, rvx, rvy, speed, count, target, dt);
+        scalarTime += NowSeconds() - start;
+    }
+
+    float maxError = 0.0f;
+    for (int i = 0; i < count; i++) {
+        float e = fmaxf(fabsf(x[i] - rx[i]), fabsf(y[i] - ry[i]));
+        if (e > maxError) maxError = e;
+    }
+
+    double simdMs = simdTime * 1000.0 / frames;
+    printf("enemies: %d, path: %s\n", count, SteerEnemiesPath());
+    printf("simd: %.3f ms/frame (worst %.3f ms), scalar: %.3f ms/frame, speedup %.2fx\n",
+           simdMs, worstFrame * 1000.0, scalarTime * 1000.0 / frames, scalarTime / simdTime);
+    printf("max deviation from scalar: %g px (tolerance %g)\n", maxError, tolerance);
+    printf("16 ms budget: %s\n", (worstFrame * 1000.0 <= 16.0) ? "met" : "MISSED");
+
+    free(data);
+    return (maxError <= tolerance) ? 0 : 1;
+}
+
+static int RunBatch(long long ticks) {
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    StartRun(&world, DIFFICULTY_EASY);
+
+    SpriteAtlas atlas;
+    LayoutDefaultGameplayAtlas(&atlas);
+    SpriteBatch batch;
+    InitSpriteBatch(&batch);
+    WorldSnapshot snapshot = { 0 };
+
+    long long sprites = 0, culled = 0, vertices = 0, drawCalls = 0, textureRuns = 0;
+    int maxDrawCalls = 0, maxSprites = 0;
+
+    for (long long i = 0; i < ticks; i++) {
+        StepWorld(&world, BotInputs(&world, world.tick), 1.0f / 60.0f);
+        if (world.state == CLOSING_SCENE) StartRun(&world, DIFFICULTY_EASY);
+
+        BeginSpriteBatch(&batch, (Rectangle){ 0, 0, 800, 600 });
+        BuildWorldSnapshot(&snapshot, &world, NULL);
+        PushGameplaySprites(&batch, &atlas, &snapshot, 1.0f);
+        EndSpriteBatch(&batch);
+
+        sprites += batch.stats.sprites;
+        culled += batch.stats.culled;
+        vertices += batch.stats.vertices;
+        drawCalls += batch.stats.drawCalls;
+        if (batch.stats.drawCalls > maxDrawCalls) maxDrawCalls = batch.stats.drawCalls;
+        if (batch.stats.sprites > maxSprites) maxSprites = batch.stats.sprites;
+
+        // Per-texture draws before the atlas: player, bullets (shapes texture), enemies, elixir
+        textureRuns += 1 + (world.bullets.pool.count > 0) + (world.enemies.pool.count > 0) + world.elixirAvailable;
+    }
+
+    printf("ticks: %lld, atlas %dx%d\n", ticks, atlas.width, atlas.height);
+    printf("per frame: %.1f sprites (max %d), %.1f culled, %.1f vertices\n",
+           (double)sprites / ticks, maxSprites, (double)culled / ticks, (double)vertices / ticks);
+    printf("draw calls per frame: %.2f batched (max %d), %.2f with one texture per sprite type\n",
+           (double)drawCalls / ticks, maxDrawCalls, (double)textureRuns / ticks);
+
+    UnloadWorldSnapshot(&snapshot);
+    UnloadSpriteBatch(&batch);
+    UnloadWorld(&world);
+    return 0;
+}
+
+static int RunRecord(const char *fileName, long long ticks, Difficulty difficulty) {
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+
+    ReplayRecorder recorder;
+    if (!BeginRecording(&recorder, &world, fileName, 12345u)) return 1;
+    RecordedStartRun(&recorder, &world, difficulty);
+
+    for (long long i = 0; i < ticks; i++) {
+        // A vsynced window mostly sees 1/60 s with the odd long frame
+        float dt = (i % 97 == 0) ? 1.0f / 30.0f : 1.0f / 60.0f;
+        RecordedStep(&recorder, &world, BotInputs(&world, world.tick), dt);
+        if (world.state == CLOSING_SCENE) RecordedStartRun(&recorder, &world, difficulty);
+    }
+
+    printf("recorded %llu steps in %zu bytes (%.2f bytes/step), final hash %016llx\n",
+           recorder.steps, recorder.bytes, recorder.steps ? (double)recorder.bytes / recorder.steps : 0.0, HashWorld(&world));
+    EndRecording(&recorder);
+    UnloadWorld(&world);
+    return 0;
+}
+
+static int RunReplay(const char *fileName, int threads) {
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    JobSystem jobs;
+    StartJobSystem(&jobs, threads);
+    world.jobs = &jobs;
+
+    ReplayPlayer player;
+    if (!OpenReplay(&player, &world, fileName)) {
+        fprintf(stderr, "headless: cannot read replay %s\n", fileName);
+        return 1;
+    }
+
+    double start = NowSeconds();
+    while (PlayReplayStep(&player, &world)) { }
+    double elapsed = NowSeconds() - start;
+
+    printf("replayed %llu steps on %d thread(s), seed %u, final hash %016llx\n", player.steps, JobWorkerCount(&jobs), player.seed, HashWorld(&world));
+    printf("elapsed: %.3f s, %.1f ns/tick\n", elapsed, player.steps ? elapsed * 1e9 / player.steps : 0.0);
+    if (player.mismatches > 0) printf("DESYNC: %llu of %llu hashes differ, first at tick %llu\n", player.mismatches, player.checks, player.firstMismatch);
+    else printf("%llu hashes match\n", player.checks);
+    if (player.corrupt) printf("stream is truncated or corrupt at byte %zu\n", player.pos);
+
+    bool ok = (player.mismatches == 0 && !player.corrupt);
+    CloseReplay(&player);
+    UnloadWorld(&world);
+    StopJobSystem(&jobs);
+    return ok ? 0 : 1;
+}
+
+static unsigned long long RunSwarm(int count, int threads, int ticks, double *nsPerTick) {
+    JobSystem jobs;
+    StartJobSystem(&jobs, threads);
+
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    world.jobs = &jobs;
+    SeedWorld(&world, 99);
+    srand(99);
+    StartRun(&world, DIFFICULTY_MEDIUM);
+    world.godMode = true;
+    for (int i = 0; i < count; i++) {
+        float angle = RandomUnit() * 2.0f * PI, distance = 100.0f + RandomUnit() * 2000.0f;
+        SpawnEnemyAt(&world, (Vector2){ 400.0f + cosf(angle) * distance, 300.0f + sinf(angle) * distance });
+    }
+
+    double start = NowSeconds();
+    for (int t = 0; t < ticks; t++) {
+        for (int b = 0; b < 64; b++) SpawnBulletAt(&world, (Vector2){ RandomUnit() * 800.0f, 600.0f }, (Vector2){ 0.0f, -400.0f }, 10.0f);
+        WorldInputs inputs = BotInputs(&world, world.tick);
+        inputs.pressed &= ~INPUT_SPECIAL;
+        StepWorld(&world, inputs, 1.0f / 60.0f);
+    }
+    *nsPerTick = (NowSeconds() - start) * 1e9 / ticks;
+
+    unsigned long long hash = HashWorld(&world);
+    UnloadWorld(&world);
+    StopJobSystem(&jobs);
+    return hash;
+}
+
+static int RunScale(int count, int maxThreads) {
+    const int ticks = 120;
+    if (maxThreads > JOB_MAX_THREADS) maxThreads = JOB_MAX_THREADS;
+    printf("enemies: %d, cpus: %d, steer path: %s\n", count, CpuCount(), SteerEnemiesPath());
+
+    double baseNs = 0.0;
+    unsigned long long reference = 0;
+    bool deterministic = true;
+    for (int threads = 1; threads <= maxThreads; threads = (threads * 2 > maxThreads && threads < maxThreads) ? maxThreads : threads * 2) {
+        double ns;
+        unsigned long long hash = RunSwarm(count, threads, ticks, &ns);
+        if (threads == 1) {
+            baseNs = ns;
+            reference = hash;
+        }
+        bool same = (hash == reference);
+        deterministic = deterministic && same;
+        printf("threads %2d: %12.1f ns/tick, speedup %5.2fx, hash %016llx%s\n", threads, ns, baseNs / ns, hash, same ? "" : "  MISMATCH");
+    }
+    return deterministic ? 0 : 1;
+}
+
+// Agent-steps whose centre sits inside a rock, for count agents walked in from the edges.
+// Flow followers also slide off the rocks the way the world's steering pass does.
+static long long WalkIntoRocks(const FlowField *field, const ObstacleMap *rocks, Vector2 target, int count, int steps, bool flow) {
+    float *data = malloc(5 * (size_t)count * sizeof(float));
+    float *x = data, *y = x + count, *vx = y + count, *vy = vx + count, *speed = vy + count;
+    srand(3);
+    for (int i = 0; i < count; i++) {
+        float t = RandomUnit();
+        switch (i % 4) {
+            case 0: x[i] = 0.0f; y[i] = t * 600.0f; break;
+            case 1: x[i] = 800.0f; y[i] = t * 600.0f; break;
+            case 2: x[i] = t * 800.0f; y[i] = 0.0f; break;
+            default: x[i] = t * 800.0f; y[i] = 600.0f; break;
+        }
+        vx[i] = vy[i] = 0.0f;
+        speed[i] = 100.0f;
+    }
+
+    long long inside = 0;
+    for (int step = 0; step < steps; step++) {
+        if (flow) SteerEnemiesFlow(field, x, y, vx, vy, speed, count, target, 1.0f / 60.0f);
+        else SteerEnemiesScalar(x, y, vx, vy, speed, count, target, 1.0f / 60.0f);
+        for (int i = 0; i < count; i++) {
+            if (flow) {
+                Vector2 p = PushOutOfObstacles(rocks, (Vector2){ x[i], y[i] }, ENEMY_RADIUS);
+                x[i] = p.x;
+                y[i] = p.y;
+            }
+            for (int r = 0; r < rocks->count; r++) inside += CheckCollisionPointRec((Vector2){ x[i], y[i] }, rocks->rects[r]);
+        }
+    }
+    free(data);
+    return inside;
+}
+
+static int RunFlow(int maxEnemies) {
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    SeedWorld(&world, 7);
+    StartRun(&world, DIFFICULTY_HARD);   // Places the rocks clear of the player
+
+    const Rectangle *rocks = world.obstacles.rects;
+    int rockCount = world.obstacles.count;
+
+    // Rebuilds are forced with a fresh obstacle version and a wandering target
+    printf("rebuild, %d rocks on 800x600:\n", rockCount);
+    const float cellSizes[] = { 40.0f, 20.0f, 10.0f, 5.0f, 2.5f };
+    for (int c = 0; c < (int)(sizeof(cellSizes)/sizeof(cellSizes[0])); c++) {
+        FlowField field;
+        InitFlowField(&field, cellSizes[c]);
+        int rebuilds = (cellSizes[c] >= 10.0f) ? 2000 : 200;
+
+        double start = NowSeconds();
+        for (int r = 0; r < rebuilds; r++) {
+            Vector2 target = { (float)((r * 37) % 800), (float)((r * 53) % 600) };
+            UpdateFlowField(&field, 800.0f, 600.0f, rocks, rockCount, ENEMY_RADIUS, (unsigned int)r + 1, target);
+        }
+        double us = (NowSeconds() - start) * 1e6 / rebuilds;
+        printf("  cell %4.1f px: %4d x %3d = %6d cells, %9.1f us/rebuild\n", cellSizes[c], field.cols, field.rows, field.cols * field.rows, us);
+        UnloadFlowField(&field);
+    }
+
+    // Per-tick steering, one grid at the game's resolution
+    FlowField field;
+    InitFlowField(&field, FLOW_CELL_SIZE);
+    UpdateFlowField(&field, 800.0f, 600.0f, rocks, rockCount, ENEMY_RADIUS, 1, world.playerPos);
+    printf("steering, cell %.0f px (homing path %s):\n", FLOW_CELL_SIZE, SteerEnemiesPath());
+    for (int count = 1000; count <= maxEnemies; count *= 10) {
+        float *data = malloc(5 * (size_t)count * sizeof(float));
+        float *x = data, *y = x + count, *vx = y + count, *vy = vx + count, *speed = vy + count;
+        const int frames = 20;
+        double homing = 0.0, flow = 0.0;
+        for (int pass = 0; pass < 2; pass++) {
+            srand(5);
+            for (int i = 0; i < count; i++) {
+                x[i] = RandomUnit() * 800.0f;
+                y[i] = RandomUnit() * 600.0f;
+                vx[i] = vy[i] = 0.0f;
+                speed[i] = 100.0f;
+            }
+            double start = NowSeconds();
+            for (int f = 0; f < frames; f++) {
+                if (pass == 0) SteerEnemies(x, y, vx, vy, speed, count, world.playerPos, 1.0f / 60.0f);
+                else SteerEnemiesFlow(&field, x, y, vx, vy, speed, count, world.playerPos, 1.0f / 60.0f);
+            }
+            *(pass == 0 ? &homing : &flow) = (NowSeconds() - start) * 1000.0 / frames;
+        }
+        printf("  %8d enemies: homing %8.3f ms/tick, flow field %8.3f ms/tick\n", count, homing, flow);
+        free(data);
+    }
+
+    // Walk a swarm in from the edges for 20 s each way
+    long long homingInside = WalkIntoRocks(&field, &world.obstacles, world.playerPos, 2000, 1200, false);
+    long long flowInside = WalkIntoRocks(&field, &world.obstacles, world.playerPos, 2000, 1200, true);
+    printf("agent-steps inside a rock: homing %lld, flow field %lld\n", homingInside, flowInside);
+
+    UnloadFlowField(&field);
+    UnloadWorld(&world);
+    return (flowInside == 0) ? 0 : 1;
+}
+
+// Same closest-point test as the tree's, so boundary cases agree bit for bit
+static bool CircleTouchesRect(Vector2 center, float radius, Rectangle rect) {
+    float nx = Clamp(center.x, rect.x, rect.x + rect.width), ny = Clamp(center.y, rect.y, rect.y + rect.height);
+    return (center.x - nx)*(center.x - nx) + (center.y - ny)*(center.y - ny) < radius*radius;
+}
+
+// Rocks overlapping each other or the clearance box; the map's own tree is not used
+static int CountPlacementFaults(const ObstacleMap *map, Rectangle keepClear) {
+    int faults = 0;
+    for (int i = 0; i < map->count; i++) {
+        Rectangle a = map->rects[i];
+        if (CheckCollisionRecs(a, keepClear)) faults++;
+        for (int j = i + 1; j < map->count; j++) {
+            Rectangle b = map->rects[j];
+            if (a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height) faults++;
+        }
+    }
+    return faults;
+}
+
+static int RunObstacles(int rocks) {
+    const Vector2 size = { 95, 50 }, player = { 79, 78 };
+    const float spacing = 1.5f * sqrtf(size.x*size.x + size.y*size.y);
+    int faults = 0;
+
+    // The game's map: four rocks on 800x600 around wherever the player stands
+    ObstacleMap map;
+    InitObstacleMap(&map);
+    RandomStream random;
+    SeedRandomStream(&random, 3, 0);
+    const int maps = 10000;
+    int shortMaps = 0;
+    double start = NowSeconds();
+    for (int m = 0; m < maps; m++) {
+        Vector2 p = { (float)RandomInt(&random, 40, 760), (float)RandomInt(&random, 40, 560) };
+        Rectangle keepClear = { p.x - player.x/2 - 100, p.y - player.y/2 - 100, player.x + 200, player.y + 200 };
+        if (PlaceObstacles(&map, &random, (Rectangle){ 100, 100, 700, 500 }, size, spacing, keepClear, 4) < 4) shortMaps++;
+        faults += CountPlacementFaults(&map, keepClear);
+    }
+    printf("800x600, 4 rocks: %.1f us/map over %d maps, %d short, %d faults\n",
+           (NowSeconds() - start) * 1e6 / maps, maps, shortMaps, faults);
+
+    // A procedural map sized so the requested count fits
+    float side = sqrtf((float)rocks * spacing * spacing * 2.0f / 12.0f);
+    Rectangle area = { 0, 0, 4.0f * side, 3.0f * side };
+    Vector2 centre = { area.width / 2, area.height / 2 };
+    Rectangle keepClear = { centre.x - player.x/2 - 100, centre.y - player.y/2 - 100, player.x + 200, player.y + 200 };
+
+    start = NowSeconds();
+    int placed = PlaceObstacles(&map, &random, area, size, spacing, keepClear, rocks);
+    double placeMs = (NowSeconds() - start) * 1e3;
+    start = NowSeconds();
+    const int builds = 100;
+    for (int b = 0; b < builds; b++) BuildStaticBvh(&map.tree, map.rects, map.count);
+    double buildUs = (NowSeconds() - start) * 1e6 / builds;
+    int bigFaults = CountPlacementFaults(&map, keepClear);
+    faults += bigFaults;
+    printf("%.0fx%.0f: placed %d of %d rocks in %.2f ms, tree of %d nodes in %.1f us, %d faults\n",
+           area.width, area.height, placed, rocks, placeMs, map.tree.nodeCount, buildUs, bigFaults);
+
+    // Player boxes, enemy and bullet circles scattered over the map, answered by both
+    const int queries = 100000;
+    const float radii[3] = { 0.0f, 20.0f, 5.0f };
+    const char *names[3] = { "player", "enemy", "bullet" };
+    Vector2 *at = malloc(queries * sizeof(Vector2));
+    bool *treeHit = malloc(queries * sizeof(bool)), *scanHit = malloc(queries * sizeof(bool));
+    int mismatches = 0;
+    for (int q = 0; q < 3; q++) {
+        srand(11 + q);
+        for (int i = 0; i < queries; i++) at[i] = (Vector2){ (float)rand() / RAND_MAX * area.width, (float)rand() / RAND_MAX * area.height };
+
+        start = NowSeconds();
+        for (int i = 0; i < queries; i++) {
+            treeHit[i] = (q == 0) ? ObstacleHitsRect(&map, (Rectangle){ at[i].x, at[i].y, player.x, player.y })
+                                  : ObstacleHitsCircle(&map, at[i], radii[q]);
+        }
+        double treeNs = (NowSeconds() - start) * 1e9 / queries;
+
+        start = NowSeconds();
+        for (int i = 0; i < queries; i++) {
+            bool hit = false;
+            for (int r = 0; r < map.count && !hit; r++) {
+                hit = (q == 0) ? CheckCollisionRecs((Rectangle){ at[i].x, at[i].y, player.x, player.y }, map.rects[r])
+                               : CircleTouchesRect(at[i], radii[q], map.rects[r]);
+            }
+            scanHit[i] = hit;
+        }
+        double scanNs = (NowSeconds() - start) * 1e9 / queries;
+
+        int hits = 0;
+        for (int i = 0; i < queries; i++) {
+            hits += treeHit[i];
+            mismatches += (treeHit[i] != scanHit[i]);
+        }
+        printf("  %-6s query: tree %8.1f ns, scan %10.1f ns (%.0fx), %d hits\n", names[q], treeNs, scanNs, scanNs / treeNs, hits);
+    }
+    free(at);
+    free(treeHit);
+    free(scanHit);
+    printf("tree/scan mismatches: %d\n", mismatches);
+
+    UnloadObstacleMap(&map);
+    return (faults == 0 && mismatches == 0) ? 0 : 1;
+}
+
+static int RunPatterns(int emitters) {
+    // Kernel paths over a field where bullets start inside, outside and on the edges
+    const int count = 1000003;
+    float *data = malloc(10 * (size_t)count * sizeof(float));
+    float *x = data, *y = x + count, *vx = y + count, *vy = vx + count, *life = vy + count;
+    float *rx = life + count, *ry = rx + count, *rlife = ry + count;
+    srand(17);
+    for (int i = 0; i < count; i++) {
+        x[i] = RandomUnit() * 1000.0f - 100.0f;
+        y[i] = RandomUnit() * 800.0f - 100.0f;
+        vx[i] = RandomUnit() * 800.0f - 400.0f;
+        vy[i] = RandomUnit() * 800.0f - 400.0f;
+        life[i] = RandomUnit() * 0.2f;
+    }
+    memcpy(rx, x, count * sizeof(float));
+    memcpy(ry, y, count * sizeof(float));
+    memcpy(rlife, life, count * sizeof(float));
+
+    const Rectangle bounds = { 0, 0, 800, 600 };
+    const int frames = 20;
+    double simd = 0.0, scalar = 0.0;
+    for (int f = 0; f < frames; f++) {
+        double start = NowSeconds();
+        IntegrateBullets(x, y, vx, vy, life, count, bounds, 1.0f / 60.0f);
+        simd += NowSeconds() - start;
+        start = NowSeconds();
+        IntegrateBulletsScalar(rx, ry, vx, vy, rlife, count, bounds, 1.0f / 60.0f);
+        scalar += NowSeconds() - start;
+    }
+    bool same = memcmp(x, rx, count * sizeof(float)) == 0 && memcmp(y, ry, count * sizeof(float)) == 0 &&
+                memcmp(life, rlife, count * sizeof(float)) == 0;
+    printf("kernel, %d bullets (%s): simd %.3f ms, scalar %.3f ms, %s\n", count, SteerEnemiesPath(),
+           simd * 1e3 / frames, scalar * 1e3 / frames, same ? "bit-identical" : "MISMATCH");
+    free(data);
+
+    // Emitters on a ring round the player, one core, no jobs
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    SeedWorld(&world, 5);
+    StartRun(&world, DIFFICULTY_EASY);
+    world.godMode = true;
+    const BulletPattern *storm = FindBulletPattern("storm");
+    for (int e = 0; e < emitters; e++) {
+        float angle = 2.0f * PI * e / emitters;
+        Vector2 facing = { cosf(angle), sinf(angle) };
+        AddEmitter(&world, storm, (Vector2){ 400.0f + 200.0f * facing.x, 300.0f + 150.0f * facing.y }, facing);
+    }
+
+    const int warmup = 600, ticks = 600;
+    for (int t = 0; t < warmup; t++) StepWorld(&world, BotInputs(&world, world.tick), 1.0f / 60.0f);
+
+    int growthsBefore = world.bullets.pool.growths, fewest = world.bullets.pool.count, most = fewest;
+    size_t arenaBefore = world.arena.used;
+    double total = 0.0, worst = 0.0;
+    for (int t = 0; t < ticks; t++) {
+        double start = NowSeconds();
+        StepWorld(&world, BotInputs(&world, world.tick), 1.0f / 60.0f);
+        double elapsed = NowSeconds() - start;
+        total += elapsed;
+        if (elapsed > worst) worst = elapsed;
+        if (world.bullets.pool.count < fewest) fewest = world.bullets.pool.count;
+        if (world.bullets.pool.count > most) most = world.bullets.pool.count;
+    }
+    int growths = world.bullets.pool.growths - growthsBefore;
+    bool steady = (growths == 0 && world.arena.used == arenaBefore);
+    printf("%d storm emitters: %d-%d live bullets, %.3f ms/tick (worst %.3f ms), 16 ms budget %s\n",
+           emitters, fewest, most, total * 1e3 / ticks, worst * 1e3, (worst * 1e3 <= 16.0) ? "met" : "MISSED");
+    printf("after warmup: %d bullet chunk growths, arena %s\n", growths, (world.arena.used == arenaBefore) ? "unchanged" : "GREW");
+
+    UnloadWorld(&world);
+    return (same && steady) ? 0 : 1;
+}
+
+// Plays one throw through a world's MINI_GAME at 60 Hz and returns the pins it felled
+static unsigned int PlayThrow(World *world, BowlingThrow bowl) {
+    StartRun(world, DIFFICULTY_MEDIUM);
+    world->state = MINI_GAME;
+    world->throwAngle = bowl.throwAngle;
+    world->power = bowl.power;
+    world->charging = true;
+    world->strikeMode = bowl.strikeMode;
+    world->luckyStrike = bowl.luckyStrike;
+
+    StepWorld(world, (WorldInputs){ .released = INPUT_FIRE }, 1.0f / 60.0f);
+    while (world->state == MINI_GAME) StepWorld(world, (WorldInputs){ 0 }, 1.0f / 60.0f);
+    return world->lastKnocked;
+}
+
+static int PinCount(unsigned int knocked) {
+    int pins = 0;
+    for (int p = 0; p < NUM_PINS; p++) pins += (knocked >> p) & 1u;
+    return pins;
+}
+
+static int RunBowling(long long throws, int maxThreads) {
+    if (maxThreads > JOB_MAX_THREADS) maxThreads = JOB_MAX_THREADS;
+    BowlingRules rules = DefaultBowlingRules();
+    BowlingLane lane = BowlingLaneFor(800.0f, 600.0f);
+
+    // The evaluator against the game itself: a grid over the legal range plus random throws
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    SeedWorld(&world, 19);
+    srand(19);
+    int played = 0, mismatches = 0;
+    for (int i = 0; i < 4000; i++) {
+        BowlingThrow bowl;
+        if (i < 41 * 41) {
+            bowl = (BowlingThrow){ rules.maxAngle * ((i / 41) / 20.0f - 1.0f), rules.maxPower * (i % 41) / 40.0f, false, false };
+        } else {
+            bowl = (BowlingThrow){ rules.maxAngle * (RandomUnit() * 2.0f - 1.0f), rules.maxPower * RandomUnit(),
+                                   RandomUnit() < 0.25f, RandomUnit() < 0.5f };
+        }
+        unsigned int expected = PlayThrow(&world, bowl), got = EvaluateThrow(&rules, &lane, bowl);
+        if (got != expected && mismatches++ < 5) {
+            printf("MISMATCH angle %.4f power %.4f strike mode %d/%d: game %03x, evaluator %03x\n",
+                   bowl.throwAngle, bowl.power, bowl.strikeMode, bowl.luckyStrike, expected, got);
+        }
+        played++;
+    }
+    UnloadWorld(&world);
+    printf("evaluator vs MINI_GAME: %d throws, %d mismatches\n", played, mismatches);
+
+    // Monte Carlo over the whole legal range, a quarter of it in strike mode
+    ThrowDistribution anyThrow = { -rules.maxAngle, rules.maxAngle, 0.0f, rules.maxPower, 0.25f };
+    BowlingStats reference = { 0 };
+    double baseSeconds = 0.0;
+    bool deterministic = true;
+    for (int threads = 1; threads <= maxThreads; threads = (threads * 2 > maxThreads && threads < maxThreads) ? maxThreads : threads * 2) {
+        JobSystem jobs;
+        StartJobSystem(&jobs, threads);
+        double start = NowSeconds();
+        BowlingStats stats = SampleThrows(&jobs, &rules, &lane, anyThrow, throws, 7);
+        double elapsed = NowSeconds() - start;
+        StopJobSystem(&jobs);
+
+        if (threads == 1) {
+            reference = stats;
+            baseSeconds = elapsed;
+        }
+        bool same = memcmp(&stats, &reference, sizeof(stats)) == 0;
+        deterministic = deterministic && same;
+        printf("threads %2d: %7.2f M throws/s, speedup %5.2fx%s\n", threads, throws / elapsed / 1e6, baseSeconds / elapsed, same ? "" : "  MISMATCH");
+    }
+    printf("strike rate %.2f%%, pins down:", 100.0 * reference.strikes / reference.throws);
+    for (int p = 0; p <= NUM_PINS; p++) printf(" %d:%.1f%%", p, 100.0 * reference.byPinsDown[p] / reference.throws);
+    printf("\n");
+
+    // Throws aimed into the rack, so every one runs the pin physics until the pins sleep
+    JobSystem jobs;
+    StartJobSystem(&jobs, maxThreads);
+    ThrowDistribution intoRack = { -0.15f, 0.15f, 0.2f, rules.maxPower, 0.0f };
+    long long racks = throws / 10;
+    double start = NowSeconds();
+    BowlingStats full = SampleThrows(&jobs, &rules, &lane, intoRack, racks, 3);
+    double rackSeconds = NowSeconds() - start;
+    printf("full racks on %d threads: %.0f racks/s, %.1f%% of them touched\n", maxThreads, racks / rackSeconds,
+           100.0 - 100.0 * full.byPinsDown[0] / full.throws);
+
+    // Tuning: the strike rule and the ball's speed, which sets how hard it hits the pins
+    ThrowDistribution plain = anyThrow;
+    plain.strikeModeChance = 0.0f;
+    const float strikePowers[] = { 0.7f, 0.8f, 0.9f }, strikeAngles[] = { 0.05f, 0.1f, 0.2f };
+    for (int p = 0; p < 3; p++) {
+        printf("strikePower %.1f, strike rate by strikeAngle:", strikePowers[p]);
+        for (int a = 0; a < 3; a++) {
+            BowlingRules tuned = rules;
+            tuned.strikePower = strikePowers[p];
+            tuned.strikeAngle = strikeAngles[a];
+            BowlingStats stats = SampleThrows(&jobs, &tuned, &lane, plain, 200000, 11);
+            printf("  %.2f: %5.2f%%", strikeAngles[a], 100.0 * stats.strikes / stats.throws);
+        }
+        printf("\n");
+    }
+    const float speeds[] = { 0.01f, 0.02f, 0.03f, 0.04f };
+    printf("mean pins felled by baseSpeed:");
+    for (int s = 0; s < 4; s++) {
+        BowlingRules tuned = rules;
+        tuned.baseSpeed = speeds[s];
+        BowlingStats stats = SampleThrows(&jobs, &tuned, &lane, plain, 200000, 11);
+        long long pins = 0;
+        for (int p = 0; p <= NUM_PINS; p++) pins += p * stats.byPinsDown[p];
+        printf("  %.2f: %.2f", speeds[s], (double)pins / stats.throws);
+    }
+    printf("\n");
+
+    // Assist: the best plain throw, checked against the game
+    start = NowSeconds();
+    BowlingThrow best = PlanThrow(&jobs, &rules, &lane, 401, 201);
+    double planMs = (NowSeconds() - start) * 1e3;
+    StopJobSystem(&jobs);
+    InitWorld(&world, 800.0f, 600.0f);
+    unsigned int knocked = PlayThrow(&world, best);
+    UnloadWorld(&world);
+    printf("assist: angle %.4f power %.3f in %.1f ms, %d pins in the game\n", best.throwAngle, best.power, planMs, PinCount(knocked));
+
+    return (mismatches == 0 && deterministic) ? 0 : 1;
+}
+
+// Gap between two shapes partway through a move, negative once they overlap
+typedef struct {
+    Vector2 a0, a1, b0, b1;   // Circles: a and b move; rectangle: a moves, rect stays
+    Rectangle rect;
+    bool    againstRect;
+    float   radius;
+} SweepCase;
+
+static float SweepGap(const SweepCase *c, float u) {
+    Vector2 a = Vector2Lerp(c->a0, c->a1, u);
+    if (!c->againstRect) return Vector2Distance(a, Vector2Lerp(c->b0, c->b1, u)) - c->radius;
+    Vector2 nearest = { Clamp(a.x, c->rect.x, c->rect.x + c->rect.width), Clamp(a.y, c->rect.y, c->rect.y + c->rect.height) };
+    return Vector2Distance(a, nearest) - c->radius;
+}
+
+// A hit holds if the shapes touch at t and stay apart at every fine step before it; a miss
+// holds if no fine step brings them together. Slack covers float rounding.
+static bool SweepHolds(const SweepCase *c, float t) {
+    const int steps = 4096;
+    const float slack = 0.01f;
+    if (t >= 0.0f && SweepGap(c, t) > slack) return false;
+    for (int s = 0; s <= steps; s++) {
+        float u = (float)s / steps;
+        if (t >= 0.0f && u >= t - 1.0f / steps) break;
+        if (SweepGap(c, u) < -slack) return false;
+    }
+    return true;
+}
+
+// A row of still enemies, each with a fast bullet fired at it from below. Also counts how
+// many an end-of-tick overlap test would have caught.
+static int ShootRow(float hz, int targets, int *discrete) {
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    SeedWorld(&world, 8);
+    StartRun(&world, DIFFICULTY_EASY);
+
+    const float speed = 2000.0f, dt = 1.0f / hz, rowY = 150.0f;
+    *discrete = 0;
+    for (int k = 0; k < targets; k++) {
+        SpawnEnemyAt(&world, (Vector2){ 100.0f + 55.0f * k, rowY });
+        int i = world.enemies.pool.count - 1;
+        ENTITY_AT(&world.enemies, speed, i) = 0.0f;
+        ENTITY_AT(&world.enemies, vx, i) = 0.0f;
+        ENTITY_AT(&world.enemies, vy, i) = 0.0f;
+
+        float startY = 420.0f + 13.0f * k;
+        SpawnBulletAt(&world, (Vector2){ 100.0f + 55.0f * k, startY }, (Vector2){ 0.0f, -speed }, 1.0f);
+        for (int n = 1; startY - speed * dt * n >= 0.0f; n++) {
+            if (fabsf(startY - speed * dt * n - rowY) <= ENEMY_RADIUS + BULLET_RADIUS) { (*discrete)++; break; }
+        }
+    }
+
+    for (int t = 0; t < (int)ceilf(0.5f * hz); t++) StepWorld(&world, (WorldInputs){ 0 }, dt);
+    int kills = world.score;
+    UnloadWorld(&world);
+    return kills;
+}
+
+// An enemy fast enough to jump clean over the player every tick; true if it still catches them
+static bool RushPlayer(float hz) {
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    SeedWorld(&world, 8);
+    StartRun(&world, DIFFICULTY_EASY);
+    SpawnEnemyAt(&world, (Vector2){ world.playerPos.x, world.playerPos.y - 430.0f });
+    ENTITY_AT(&world.enemies, speed, world.enemies.pool.count - 1) = 500.0f * hz;
+
+    for (int t = 0; t < 3 && world.state == GAMEPLAY; t++) StepWorld(&world, (WorldInputs){ 0 }, 1.0f / hz);
+    bool caught = (world.state != GAMEPLAY);
+    UnloadWorld(&world);
+    return caught;
+}
+
+static int RunSweep(int cases) {
+    // The exact tests against fine stepping of the same moves
+    srand(21);
+    int faults = 0, hits = 0;
+    for (int n = 0; n < cases; n++) {
+        SweepCase c = { 0 };
+        c.a0 = (Vector2){ RandomUnit() * 400.0f, RandomUnit() * 400.0f };
+        c.a1 = (Vector2){ RandomUnit() * 400.0f, RandomUnit() * 400.0f };
+        c.radius = 2.0f + RandomUnit() * 40.0f;
+        c.againstRect = (n & 1) != 0;
+        float t;
+        if (c.againstRect) {
+            c.rect = (Rectangle){ 100.0f + RandomUnit() * 150.0f, 100.0f + RandomUnit() * 150.0f, 5.0f + RandomUnit() * 100.0f, 5.0f + RandomUnit() * 100.0f };
+            t = SweepCircleRect(c.a0, c.a1, c.radius, c.rect);
+        } else {
+            c.b0 = (Vector2){ RandomUnit() * 400.0f, RandomUnit() * 400.0f };
+            c.b1 = (Vector2){ RandomUnit() * 400.0f, RandomUnit() * 400.0f };
+            t = SweepCircles(c.a0, c.a1, c.b0, c.b1, c.radius);
+        }
+        hits += (t >= 0.0f);
+        if (!SweepHolds(&c, t)) faults++;
+    }
+    printf("sweep tests: %d cases, %d hits, %d disagree with fine stepping\n", cases, hits, faults);
+
+    // The tree's earliest rock against a scan of them all
+    ObstacleMap map;
+    InitObstacleMap(&map);
+    RandomStream random;
+    SeedRandomStream(&random, 4, 0);
+    PlaceObstacles(&map, &random, (Rectangle){ 0, 0, 4000, 3000 }, (Vector2){ 95, 50 }, 160.0f, (Rectangle){ 0 }, 400);
+    int treeFaults = 0;
+    for (int n = 0; n < cases; n++) {
+        Vector2 from = { RandomUnit() * 4000.0f, RandomUnit() * 3000.0f };
+        Vector2 to = { from.x + RandomUnit() * 600.0f - 300.0f, from.y + RandomUnit() * 600.0f - 300.0f };
+        float best = -1.0f;
+        for (int r = 0; r < map.count; r++) {
+            float t = SweepCircleRect(from, to, BULLET_RADIUS, map.rects[r]);
+            if (t >= 0.0f && (best < 0.0f || t < best)) best = t;
+        }
+        if (ObstacleSweepCircle(&map, from, to, BULLET_RADIUS) != best) treeFaults++;
+    }
+    UnloadObstacleMap(&map);
+    printf("rock sweeps: tree/scan mismatches %d\n", treeFaults);
+
+    // The world at lower step rates
+    const float rates[] = { 60.0f, 30.0f, 20.0f, 10.0f, 5.0f };
+    const int targets = 12;
+    int lost = 0;
+    for (int r = 0; r < 5; r++) {
+        int discrete, kills = ShootRow(rates[r], targets, &discrete);
+        bool caught = RushPlayer(rates[r]);
+        lost += (targets - kills) + !caught;
+        printf("%2.0f Hz: %2d of %d bullets hit (end-of-tick test: %2d), fast enemy %s the player\n",
+               rates[r], kills, targets, discrete, caught ? "catches" : "MISSES");
+    }
+
+    return (faults == 0 && treeFaults == 0 && lost == 0) ? 0 : 1;
+}
+
+// Frame time of the model display: the CPU and a GPU cost proportional to the pixels shaded,
+// held to the budget by the frame cap, with a little jitter
+static float ModelFrame(float budget, float cpu, float gpuFull, float scale) {
+    float busy = (cpu + gpuFull * scale * scale) * (0.97f + 0.06f * RandomUnit());
+    return (busy > budget) ? busy : budget;
+}
+
+static int RunResolution(int frames) {
+    const float budget = 1.0f / 60.0f, cpu = 0.003f;
+    const float loads[3] = { 0.008f, 0.022f, 0.008f };   // GPU seconds for a full-resolution frame
+    const char *names[3] = { "light", "heavy", "light" };
+
+    srand(23);
+    ResolutionController controller;
+    InitResolutionController(&controller, budget);
+    float scale = ResolutionScale(&controller);
+    int wrong = 0;
+
+    for (int phase = 0; phase < 3; phase++) {
+        // The highest scale whose frames fit in the budget even at the top of the jitter
+        float best = 1.0f - RESOLUTION_STEP * (RESOLUTION_LEVELS - 1);
+        for (int level = 0; level < RESOLUTION_LEVELS; level++) {
+            float s = 1.0f - RESOLUTION_STEP * (float)level;
+            if ((cpu + loads[phase] * s * s) * 1.03f <= budget) { best = s; break; }
+        }
+
+        int over = 0, atBest = 0, changes = controller.changes;
+        for (int f = 0; f < frames; f++) {
+            float frame = ModelFrame(budget, cpu, loads[phase], scale);
+            if (frame > budget * 1.05f) over++;
+            scale = UpdateResolutionScale(&controller, frame);
+            if (f >= frames / 2 && fabsf(scale - best) < 0.01f) atBest++;
+        }
+
+        // Settled: at the best scale for most of the second half, probes aside
+        bool settled = atBest * 10 >= (frames - frames / 2) * 9;
+        wrong += !settled;
+        printf("%-5s load (%2.0f ms GPU at full res): best scale %.1f, at it %5.1f%% of the second half, "
+               "%d changes, %5.2f%% of frames over budget\n", names[phase], loads[phase] * 1000.0f, best,
+               100.0f * (float)atBest / (float)(frames - frames / 2), controller.changes - changes, 100.0f * (float)over / (float)frames);
+    }
+
+    // Letterboxing keeps the virtual aspect in any window
+    const int windows[3][2] = { { 800, 600 }, { 1920, 1080 }, { 600, 900 } };
+    for (int w = 0; w < 3; w++) {
+        Rectangle view = VirtualViewport(VIRTUAL_WIDTH, VIRTUAL_HEIGHT, windows[w][0], windows[w][1]);
+        printf("%4dx%-4d window: virtual screen at (%.0f, %.0f) size %.0fx%.0f\n", windows[w][0], windows[w][1], view.x, view.y, view.width, view.height);
+        if (fabsf(view.width * VIRTUAL_HEIGHT - view.height * VIRTUAL_WIDTH) > 1.0f) wrong++;
+    }
+
+    return (wrong == 0) ? 0 : 1;
+}
+
+// ------------ Random streams ------------
+static bool SameRockMap(const ObstacleMap *a, const ObstacleMap *b) {
+    return a->count == b->count && memcmp(a->rects, b->rects, a->count * sizeof(Rectangle)) == 0;
+}
+
+// Two worlds stepped a tick each in turn, then one after the other
+static bool InterleavingHolds(void) {
+    static World a, b;
+    unsigned long long hashes[2][2];
+    for (int pass = 0; pass < 2; pass++) {
+        InitWorld(&a, 800.0f, 600.0f);
+        InitWorld(&b, 800.0f, 600.0f);
+        SeedWorld(&a, 41);
+        SeedWorld(&b, 42);
+        StartRun(&a, DIFFICULTY_HARD);
+        StartRun(&b, DIFFICULTY_EASY);
+        for (int t = 0; t < 2000; t++) {
+            if (pass == 0) StepWorld(&a, BotInputs(&a, a.tick), 1.0f / 60.0f);
+            StepWorld(&b, BotInputs(&b, b.tick), 1.0f / 60.0f);
+        }
+        for (int t = 0; pass == 1 && t < 2000; t++) StepWorld(&a, BotInputs(&a, a.tick), 1.0f / 60.0f);
+        hashes[pass][0] = HashWorld(&a);
+        hashes[pass][1] = HashWorld(&b);
+        UnloadWorld(&a);
+        UnloadWorld(&b);
+    }
+    return hashes[0][0] == hashes[1][0] && hashes[0][1] == hashes[1][1];
+}
+
+static int RunRandom(int count) {
+    unsigned int *bits = malloc(count * sizeof(unsigned int)), *scalarBits = malloc(count * sizeof(unsigned int));
+    int *ints = malloc(count * sizeof(int)), *scalarInts = malloc(count * sizeof(int));
+    float *floats = malloc(count * sizeof(float)), *scalarFloats = malloc(count * sizeof(float));
+    int wrong = 0;
+
+    // The vector fills against single draws, over uneven lengths and awkward ranges
+    const int ranges[4][2] = { { 0, 1 }, { -300, 299 }, { 0, 0x7FFFFFFF }, { (int)0x80000000, 0x7FFFFFFF } };
+    int differ = 0;
+    for (int r = 0; r < 4; r++) {
+        RandomStream vector, scalar;
+        SeedRandomStream(&vector, 11, (unsigned int)r);
+        scalar = vector;
+        int n = count - r;
+        FillRandom(&vector, bits, n);
+        FillRandomScalar(&scalar, scalarBits, n);
+        FillRandomInts(&vector, ints, n, ranges[r][0], ranges[r][1]);
+        FillRandomIntsScalar(&scalar, scalarInts, n, ranges[r][0], ranges[r][1]);
+        FillRandomFloats(&vector, floats, n, -1.5f, 800.0f);
+        FillRandomFloatsScalar(&scalar, scalarFloats, n, -1.5f, 800.0f);
+        differ += memcmp(bits, scalarBits, n * sizeof(unsigned int)) != 0;
+        differ += memcmp(ints, scalarInts, n * sizeof(int)) != 0;
+        differ += memcmp(floats, scalarFloats, n * sizeof(float)) != 0;
+        for (int i = 0; i < n; i++) differ += (ints[i] < ranges[r][0] || ints[i] > ranges[r][1] || floats[i] < -1.5f || floats[i] >= 800.0f);
+        differ += (vector.counter != scalar.counter);
+    }
+    printf("fill path: %s, %s to single draws\n", FillRandomPath(), differ ? "MISMATCH" : "bit-identical");
+    wrong += (differ > 0);
+
+    // Throughput: raylib's global generator, single draws, bulk fills
+    RandomStream stream;
+    SeedRandomStream(&stream, 12, 0);
+    unsigned int sink = 0;
+    double start = NowSeconds();
+    for (int i = 0; i < count; i++) sink += (unsigned int)GetRandomValue(0, 1000);
+    double global = NowSeconds() - start;
+    start = NowSeconds();
+    for (int i = 0; i < count; i++) sink += (unsigned int)RandomInt(&stream, 0, 1000);
+    double single = NowSeconds() - start;
+    start = NowSeconds();
+    FillRandomInts(&stream, ints, count, 0, 1000);
+    double bulk = NowSeconds() - start;
+    printf("%d ints in 0..1000: GetRandomValue %.2f ns, RandomInt %.2f ns, FillRandomInts %.2f ns each (%u)\n",
+           count, global * 1e9 / count, single * 1e9 / count, bulk * 1e9 / count, sink & 1);
+
+    // Uniformity: chi-square over 16 buckets and the mean of unit floats
+    long long buckets[16] = { 0 };
+    for (int i = 0; i < count; i++) buckets[bits[i] >> 28]++;
+    double chi = 0.0, expected = (double)count / 16.0, mean = 0.0;
+    for (int b = 0; b < 16; b++) chi += (buckets[b] - expected) * (buckets[b] - expected) / expected;
+    FillRandomFloats(&stream, floats, count, 0.0f, 1.0f);
+    for (int i = 0; i < count; i++) mean += floats[i];
+    mean /= count;
+    printf("uniformity: chi-square %.1f over 16 buckets (15 dof, 37.7 at p = 0.001), unit mean %.4f\n", chi, mean);
+    wrong += (chi > 37.7 || fabs(mean - 0.5) > 0.01);
+
+    // A spawn burst lands where the same enemies spawned one at a time would
+    static World burst, oneByOne;
+    InitWorld(&burst, 800.0f, 600.0f);
+    InitWorld(&oneByOne, 800.0f, 600.0f);
+    SpawnEnemyBurst(&burst, 1000);
+    for (int i = 0; i < 1000; i++) SpawnEnemyBurst(&oneByOne, 1);
+    bool sameBurst = burst.enemies.pool.count == oneByOne.enemies.pool.count;
+    for (int i = 0; i < burst.enemies.pool.count && sameBurst; i++) {
+        sameBurst = ENTITY_AT(&burst.enemies, x, i) == ENTITY_AT(&oneByOne.enemies, x, i) && ENTITY_AT(&burst.enemies, y, i) == ENTITY_AT(&oneByOne.enemies, y, i);
+    }
+
+    // Streams are independent: the burst above drew only spawn values, so rocks come out the
+    // same as in a world that spawned nothing
+    StartRun(&burst, DIFFICULTY_HARD);
+    static World fresh;
+    InitWorld(&fresh, 800.0f, 600.0f);
+    StartRun(&fresh, DIFFICULTY_HARD);
+    bool sameRocks = SameRockMap(&burst.obstacles, &fresh.obstacles);
+    SeedWorld(&fresh, 1);
+    StartRun(&fresh, DIFFICULTY_HARD);
+    bool otherSeed = !SameRockMap(&burst.obstacles, &fresh.obstacles);
+    UnloadWorld(&fresh);
+    UnloadWorld(&oneByOne);
+    UnloadWorld(&burst);
+
+    // No seed and id share a key with another: not a seed shifted by the id, nor the two swapped
+    int shared = 0, keys = 0;
+    for (unsigned long long seed = 0; seed < 64; seed++) {
+        for (unsigned int id = 0; id < RANDOM_STREAMS; id++, keys++) {
+            RandomStream a, b;
+            SeedRandomStream(&a, seed, id);
+            for (unsigned long long other = 0; other < 64; other++) {
+                for (unsigned int otherId = 0; otherId < RANDOM_STREAMS; otherId++) {
+                    if (other == seed && otherId == id) continue;
+                    SeedRandomStream(&b, other, otherId);
+                    shared += (a.key[0] == b.key[0] && a.key[1] == b.key[1]);
+                }
+            }
+            SeedRandomStream(&b, seed ^ ((unsigned long long)id << 32), 0);
+            shared += (id != 0 && a.key[0] == b.key[0] && a.key[1] == b.key[1]);
+        }
+    }
+
+    bool interleaved = InterleavingHolds();
+    printf("burst of 1000 %s single spawns; rocks after it %s; another seed %s; %d of %d seeds and ids share a key; "
+           "two worlds %s when interleaved\n",
+           sameBurst ? "matches" : "DIFFERS from", sameRocks ? "unchanged" : "CHANGED", otherSeed ? "places other rocks" : "places the SAME rocks",
+           shared, keys, interleaved ? "reproduce" : "DIFFER");
+    wrong += !sameBurst + !sameRocks + !otherSeed + (shared > 0) + !interleaved;
+
+    free(bits);
+    free(scalarBits);
+    free(ints);
+    free(scalarInts);
+    free(floats);
+    free(scalarFloats);
+    return (wrong == 0) ? 0 : 1;
+}
+
+// Held buttons for a render frame: sweeps the four directions, taps fire and strike mode
+static unsigned int ScriptedButtons(long long frame) {
+    static const unsigned int moves[4] = { INPUT_LEFT | INPUT_UP, INPUT_RIGHT, INPUT_DOWN, INPUT_LEFT };
+    unsigned int buttons = moves[(frame / 72) % 4];
+    if ((frame / 9) % 4 == 0) buttons |= INPUT_FIRE;
+    if (frame % 600 == 300) buttons |= INPUT_SPECIAL;
+    return buttons;
+}
+
+static int RunThreaded(const char *fileName, double seconds, Difficulty difficulty) {
+    const double frameTime = 1.0 / 144.0, stallTime = 0.05;
+    const int simHz = 60;
+
+    JobSystem jobs;
+    StartJobSystem(&jobs, 0);
+    static Simulation sim;
+    StartSimulation(&sim, 800.0f, 600.0f, simHz, &jobs, fileName, 12345u);
+
+    SimCommand view = { .type = SIM_VIEW, .size = { 800, 600 }, .playerSize = { 79, 78 }, .obstacleSize = { 95, 50 } };
+    SendSimCommand(&sim, view);
+    SendSimCommand(&sim, (SimCommand){ .type = SIM_START_RUN, .difficulty = difficulty });
+
+    long long frames = 0, fresh = 0, backwards = 0, runs = 1, dropped = 0;
+    unsigned long long lastTick = 0;
+    unsigned int held = 0;
+    double worstCall = 0.0;
+    const WorldSnapshot *last = NULL;
+
+    double start = NowSeconds();
+    while (NowSeconds() - start < seconds) {
+        double callStart = NowSeconds();
+        const WorldSnapshot *snapshot = LatestSnapshot(&sim);
+
+        unsigned int buttons = ScriptedButtons(frames);
+        WorldInputs inputs = { buttons, buttons & ~held, held & ~buttons };
+        held = buttons;
+        if (!SendSimCommand(&sim, (SimCommand){ .type = SIM_INPUT, .inputs = inputs })) dropped++;
+        if (snapshot->state == CLOSING_SCENE && snapshot != last) {
+            SendSimCommand(&sim, (SimCommand){ .type = SIM_START_RUN, .difficulty = difficulty });
+            runs++;
+        }
+        double call = NowSeconds() - callStart;
+        if (call > worstCall) worstCall = call;
+
+        if (snapshot != last) {
+            fresh++;
+            if (snapshot->tick < lastTick) backwards++;
+            lastTick = snapshot->tick;
+            last = snapshot;
+        }
+
+        // "Draw" for a frame, with a missed vsync every second
+        frames++;
+        SleepSeconds((frames % 144 == 0) ? stallTime : frameTime);
+    }
+    double elapsed = NowSeconds() - start;
+    StopSimulation(&sim);
+    StopJobSystem(&jobs);
+
+    double stepRate = (double)lastTick / elapsed;
+    printf("threaded: %.1f s, %lld render frames (%lld with a new snapshot), %lld runs\n", elapsed, frames, fresh, runs);
+    printf("simulation: %.1f steps/s at %d Hz across render stalls of %.0f ms\n", stepRate, simHz, stallTime * 1000.0);
+    printf("longest render-side call: %.1f us, inputs dropped on a full queue: %lld\n", worstCall * 1e6, dropped);
+    printf("snapshots going back in time: %lld\n", backwards);
+    if (backwards > 0) return 1;
+
+    // The recording holds what the simulation actually stepped with, however the input arrived
+    return RunReplay(fileName, 1);
+}
+
+// A Hard run where any full rack counts as a strike, so the second chance always resumes
+static void StartLoopbackRun(World *world, unsigned int seed) {
+    SeedWorld(world, seed);
+    StartRun(world, DIFFICULTY_HARD);
+    world->bowling.strikePower = 0.0f;
+    world->bowling.strikeAngle = world->bowling.maxAngle + 1.0f;
+}
+
+typedef struct {
+    long long ticks;
+    long long runs;
+    long long resumes;
+    long long rollbacks;
+    long long resimulated;
+    long long differ;        // Confirmed ticks whose state did not match the reference
+    long long rockDeaths;    // First deaths with the player on a rock
+    long long clear;         // Resumes with the player outside every rock's clearance
+    long long pinned;        // Resumes on a rock, or after a rock death ending on the very next tick
+} LoopbackStats;
+
+typedef WorldInputs (*LoopbackSender)(const World *world, unsigned long long tick);
+
+// Heads straight for the first rock whenever the run is on, and bowls like the bot
+static WorldInputs RockWalkerInputs(const World *world, unsigned long long tick) {
+    if (world->state != GAMEPLAY || world->obstacles.count == 0) return BotInputs(world, tick);
+    Rectangle rock = world->obstacles.rects[0];
+    float dx = rock.x + rock.width/2 - world->playerPos.x, dy = rock.y + rock.height/2 - world->playerPos.y;
+    unsigned int down = 0;
+    if (dx < -2.0f) down |= INPUT_LEFT;
+    if (dx > 2.0f)  down |= INPUT_RIGHT;
+    if (dy < -2.0f) down |= INPUT_UP;
+    if (dy > 2.0f)  down |= INPUT_DOWN;
+    return (WorldInputs){ down, 0, 0 };
+}
+
+static bool PlayerNearRock(const World *world, float margin) {
+    Rectangle player = { world->playerPos.x - world->playerSize.x/2 - margin, world->playerPos.y - world->playerSize.y/2 - margin,
+                         world->playerSize.x + 2*margin, world->playerSize.y + 2*margin };
+    return ObstacleHitsRect(&world->obstacles, player);
+}
+
+// One run played twice from the same seed. The sender plays the reference on time; the
+// rollback world hears each of its inputs delay ticks late and steps ahead on predictions.
+// Every confirmed tick's state is checked against the reference as that tick began.
+static void PlayLoopbackRun(World *reference, World *world, World *check, LoopbackSender sender, int delay, unsigned int seed, long long maxTicks, LoopbackStats *stats) {
+    StartLoopbackRun(reference, seed);
+    StartLoopbackRun(world, seed);
+    RollbackSession session;
+    InitRollback(&session);
+
+    WorldInputs sent[ROLLBACK_WINDOW];
+    unsigned long long hashes[ROLLBACK_WINDOW];
+    long long t = 0, resumedAt = -1;
+    bool rockDeath = false;
+
+    // The run ends at the second death; the late inputs then drain
+    for (; t < maxTicks && reference->state != CLOSING_SCENE; t++) {
+        WorldInputs inputs = sender(reference, reference->tick);
+        float dt = (t % 97 == 0) ? 1.0f / 30.0f : 1.0f / 60.0f;
+        sent[t % ROLLBACK_WINDOW] = inputs;
+        hashes[t % ROLLBACK_WINDOW] = HashWorld(reference);
+        GameState before = reference->state;
+        StepWorld(reference, inputs, dt);
+        if (before == GAMEPLAY && reference->state == MINI_GAME) {
+            rockDeath = PlayerNearRock(reference, 4.0f);
+            stats->rockDeaths += rockDeath;
+        }
+        if (before == MINI_GAME && reference->state == GAMEPLAY) {
+            stats->resumes++;
+            stats->clear += !PlayerNearRock(reference, OBSTACLE_CLEARANCE - 0.5f);
+            stats->pinned += PlayerNearRock(reference, 0.0f);
+            resumedAt = t;
+        }
+        if (reference->state == CLOSING_SCENE && rockDeath && resumedAt == t - 1) stats->pinned++;
+
+        RollbackStep(&session, world, dt);
+        if (t < delay) continue;
+        if (!ConfirmInputs(&session, world, sent[(t - delay) % ROLLBACK_WINDOW])) stats->differ++;
+
+        // Every tick before the oldest unconfirmed one was stepped with real inputs only
+        int slot = (int)(session.confirmed % ROLLBACK_WINDOW);
+        if (!RestoreWorldCheckpoint(check, &session.saves[slot]) || HashWorld(check) != hashes[slot]) stats->differ++;
+    }
+    while (session.confirmed < session.stepped && ConfirmInputs(&session, world, sent[session.confirmed % ROLLBACK_WINDOW])) {}
+    if (HashWorld(world) != HashWorld(reference)) stats->differ++;
+
+    stats->ticks += t;
+    stats->runs++;
+    stats->rollbacks += session.rollbacks;
+    stats->resimulated += session.resimulated;
+    UnloadRollback(&session);
+}
+
+static int RunRollback(long long ticks) {
+    const int delays[4] = { 1, 2, 4, 8 };
+    static World reference, world, check;
+    int wrong = 0;
+
+    // Fresh worlds per delay, so each plays the same runs
+    for (int d = 0; d < 4; d++) {
+        InitWorld(&reference, 800.0f, 600.0f);
+        InitWorld(&world, 800.0f, 600.0f);
+        InitWorld(&check, 800.0f, 600.0f);
+        LoopbackStats stats = { 0 };
+        for (unsigned int seed = 1; stats.ticks < ticks; seed++) {
+            PlayLoopbackRun(&reference, &world, &check, BotInputs, delays[d], seed, ticks - stats.ticks, &stats);
+        }
+        printf("delay %d: %lld ticks in %lld runs, %lld rollbacks, %lld ticks resimulated (%.2f per tick), "
+               "%lld second chances resumed (%lld pinned), %lld ticks differ\n", delays[d], stats.ticks, stats.runs, stats.rollbacks,
+               stats.resimulated, (double)stats.resimulated / stats.ticks, stats.resumes, stats.pinned, stats.differ);
+        if (stats.differ > 0 || stats.resumes == 0 || stats.pinned > 0) wrong++;
+        UnloadWorld(&check);
+        UnloadWorld(&world);
+        UnloadWorld(&reference);
+    }
+
+    // Runs that end by walking into a rock resume clear of it, and the same on the late side
+    InitWorld(&reference, 800.0f, 600.0f);
+    InitWorld(&world, 800.0f, 600.0f);
+    InitWorld(&check, 800.0f, 600.0f);
+    LoopbackStats rocks = { 0 };
+    for (unsigned int seed = 1; seed <= 20; seed++) PlayLoopbackRun(&reference, &world, &check, RockWalkerInputs, 4, seed, ticks, &rocks);
+    printf("rock walker, delay 4: %lld runs, %lld rock deaths, %lld resumed, %lld of them clear of every rock's clearance, "
+           "%lld pinned, %lld ticks differ\n", rocks.runs, rocks.rockDeaths, rocks.resumes, rocks.clear, rocks.pinned, rocks.differ);
+    if (rocks.differ > 0 || rocks.rockDeaths < rocks.runs || rocks.resumes < rocks.runs || rocks.pinned > 0) wrong++;
+    UnloadWorld(&check);
+    UnloadWorld(&world);
+    UnloadWorld(&reference);
+
+    // Save and restore cost for a busy Hard world
+    InitWorld(&world, 800.0f, 600.0f);
+    SeedWorld(&world, 777u);
+    StartRun(&world, DIFFICULTY_HARD);
+    world.godMode = true;
+    WorldCheckpoint earlier = { 0 };
+    for (int i = 0; i < 3600; i++) {
+        if (i == 1800) SaveWorldCheckpoint(&world, &earlier);
+        StepWorld(&world, BotInputs(&world, world.tick), 1.0f / 60.0f);
+    }
+
+    // An earlier checkpoint cut short, or with bytes left over, is refused before any of the
+    // later world is written
+    WorldCheckpoint damaged = { 0 };
+    int refused = 0, cuts = 0;
+    unsigned long long before = HashWorld(&world);
+    for (size_t size = sizeof(CheckpointHeader); size <= earlier.size + 8; size += 1 + earlier.size / 64, cuts++) {
+        if (size == earlier.size) size++;
+        damaged.data = realloc(damaged.data, size);
+        damaged.size = damaged.capacity = size;
+        memset(damaged.data, 0, size);
+        memcpy(damaged.data, earlier.data, (size < earlier.size) ? size : earlier.size);
+        ((CheckpointHeader *)damaged.data)->size = (unsigned int)size;
+        refused += !RestoreWorldCheckpoint(&world, &damaged);
+    }
+    bool untouched = HashWorld(&world) == before;
+    printf("damaged checkpoints: %d of %d refused, world %s\n", refused, cuts, untouched ? "untouched" : "CHANGED");
+    if (refused < cuts || !untouched) wrong++;
+    UnloadWorldCheckpoint(&damaged);
+    UnloadWorldCheckpoint(&earlier);
+
+    const int reps = 2000;
+    WorldCheckpoint checkpoint = { 0 };
+    double start = NowSeconds();
+    for (int i = 0; i < reps; i++) SaveWorldCheckpoint(&world, &checkpoint);
+    double save = (NowSeconds() - start) / reps;
+    unsigned long long hash = HashWorld(&world);
+    start = NowSeconds();
+    for (int i = 0; i < reps; i++) RestoreWorldCheckpoint(&world, &checkpoint);
+    double restore = (NowSeconds() - start) / reps;
+    printf("checkpoint of %d enemies and %d bullets: %zu bytes, save %.2f us, restore %.2f us\n",
+           world.enemies.pool.count, world.bullets.pool.count, checkpoint.size, save * 1e6, restore * 1e6);
+    if (HashWorld(&world) != hash) wrong++;
+
+    UnloadWorldCheckpoint(&checkpoint);
+    UnloadWorld(&world);
+    return (wrong == 0) ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "batch") == 0) return RunBatch((argc > 2) ? atoll(argv[2]) : 20000);
+    if (argc > 1 && strcmp(argv[1], "stress") == 0) return RunStress((argc > 2) ? atoi(argv[2]) : 100000);
+    if (argc > 1 && strcmp(argv[1], "steer") == 0) return RunSteer((argc > 2) ? atoi(argv[2]) : 1000000);
+    if (argc > 2 && strcmp(argv[1], "record") == 0)
+        return RunRecord(argv[2], (argc > 3) ? atoll(argv[3]) : 100000, (argc > 4) ? ParseDifficulty(argv[4]) : DIFFICULTY_HARD);
+    if (argc > 2 && strcmp(argv[1], "replay") == 0) return RunReplay(argv[2], (argc > 3) ? atoi(argv[3]) : 1);
+    if (argc > 2 && strcmp(argv[1], "threaded") == 0)
+        return RunThreaded(argv[2], (argc > 3) ? atof(argv[3]) : 5.0, (argc > 4) ? ParseDifficulty(argv[4]) : DIFFICULTY_HARD);
+    if (argc > 1 && strcmp(argv[1], "flow") == 0) return RunFlow((argc > 2) ? atoi(argv[2]) : 1000000);
+    if (argc > 1 && strcmp(argv[1], "obstacles") == 0) return RunObstacles((argc > 2) ? atoi(argv[2]) : 5000);
+    if (argc > 1 && strcmp(argv[1], "patterns") == 0) return RunPatterns((argc > 2) ? atoi(argv[2]) : 8);
+    if (argc > 1 && strcmp(argv[1], "sweep") == 0) return RunSweep((argc > 2) ? atoi(argv[2]) : 100000);
+    if (argc > 1 && strcmp(argv[1], "resolution") == 0) return RunResolution((argc > 2) ? atoi(argv[2]) : 3600);
+    if (argc > 1 && strcmp(argv[1], "rollback") == 0) return RunRollback((argc > 2) ? atoll(argv[2]) : 20000);
+    if (argc > 1 && strcmp(argv[1], "random") == 0) return RunRandom((argc > 2) ? atoi(argv[2]) : 10000000);
+    if (argc > 1 && strcmp(argv[1], "bowling") == 0) return RunBowling((argc > 2) ? atoll(argv[2]) : 10000000, CpuCount());
+    if (argc > 1 && strcmp(argv[1], "scale") == 0) return RunScale((argc > 2) ? atoi(argv[2]) : 100000, (argc > 3) ? atoi(argv[3]) : CpuCount());
+
+    long long ticks = (argc > 1) ? atoll(argv[1]) : 100000;
+    Difficulty difficulty = (argc > 2) ? ParseDifficulty(argv[2]) : DIFFICULTY_HARD;
+    const float dt = 1.0f / 60.0f;
+
+    static World world;
+    InitWorld(&world, 800.0f, 600.0f);
+    StartRun(&world, difficulty);
+
+    int runs = 1;
+    int bestScore = 0;
+
+    double start = NowSeconds();
+    for (long long i = 0; i < ticks; i++) {
+        StepWorld(&world, BotInputs(&world, world.tick), dt);
+        if (world.score > bestScore) bestScore = world.score;
+
+        if (world.state == CLOSING_SCENE) {
+            StartRun(&world, difficulty);
+            runs++;
+        }
+    }
+    double elapsed = NowSeconds() - start;
+
+    printf("ticks: %lld\n", ticks);
+    printf("runs: %d, best score: %d\n", runs, bestScore);
+    printf("elapsed: %.3f s, %.0f ticks/s, %.1f ns/tick\n",
+           elapsed, (elapsed > 0.0) ? ticks / elapsed : 0.0, (ticks > 0) ? elapsed * 1e9 / ticks : 0.0);
+    printf("enemies: peak %d, capacity %d, %d chunk growths\n",
+           world.enemies.pool.peakCount, world.enemies.pool.capacity, world.enemies.pool.growths);
+    printf("bullets: peak %d, capacity %d, %d chunk growths\n",
+           world.bullets.pool.peakCount, world.bullets.pool.capacity, world.bullets.pool.growths);
+    printf("arena: %zu bytes used of %zu reserved in %d blocks\n",
+           world.arena.used, world.arena.reserved, world.arena.blockCount);
+
+    UnloadWorld(&world);
+
+    return 0;
+}
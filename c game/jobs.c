@@ -0,0 +1,173 @@
+#include "jobs.h"
+#include <string.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+
+#if defined(JOBS_THREADED)
+    #include <sched.h>
+#endif
+
+#define PACK_RANGE(begin, end)  (((unsigned long long)(unsigned int)(end) << 32) | (unsigned int)(begin))
+#define RANGE_BEGIN(range)      ((int)(unsigned int)(range))
+#define RANGE_END(range)        ((int)((range) >> 32))
+
+int CpuCount(void) {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (int)count : 1;
+#else
+    return 1;
+#endif
+}
+
+int JobWorkerCount(const JobSystem *jobs) {
+    return (jobs != NULL && jobs->threadCount > 0) ? jobs->threadCount : 1;
+}
+
+#if defined(JOBS_THREADED)
+// ------------ Queues ------------
+static bool TakeFront(JobQueue *queue, int *batch) {
+    unsigned long long range = __atomic_load_n(&queue->range, __ATOMIC_ACQUIRE);
+    while (RANGE_BEGIN(range) < RANGE_END(range)) {
+        unsigned long long rest = PACK_RANGE(RANGE_BEGIN(range) + 1, RANGE_END(range));
+        if (__atomic_compare_exchange_n(&queue->range, &range, rest, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *batch = RANGE_BEGIN(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Splits off the back half of the first non-empty queue after the thief's own; the thief runs
+// the first batch of it and keeps the rest in its own queue, where others can steal in turn
+static bool StealHalf(JobSystem *jobs, int thief, int *batch) {
+    for (int k = 1; k < jobs->threadCount; k++) {
+        JobQueue *victim = &jobs->queues[(thief + k) % jobs->threadCount];
+        unsigned long long range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+
+        while (RANGE_BEGIN(range) < RANGE_END(range)) {
+            int begin = RANGE_BEGIN(range), end = RANGE_END(range);
+            int mid = begin + (end - begin) / 2;
+            if (__atomic_compare_exchange_n(&victim->range, &range, PACK_RANGE(begin, mid), true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                *batch = mid;
+                __atomic_store_n(&jobs->queues[thief].range, PACK_RANGE(mid + 1, end), __ATOMIC_RELEASE);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void WorkUntilDry(JobSystem *jobs, int worker) {
+    int batch;
+    while (TakeFront(&jobs->queues[worker], &batch) || StealHalf(jobs, worker, &batch)) {
+        // The claim above acquired everything ParallelFor() published before dealing the queues
+        int begin = batch * jobs->grain;
+        int end = (begin + jobs->grain < jobs->count) ? begin + jobs->grain : jobs->count;
+        jobs->func(jobs->context, begin, end, worker);
+        __atomic_fetch_sub(&jobs->pending, 1, __ATOMIC_RELEASE);
+    }
+}
+
+static void *WorkerMain(void *arg) {
+    JobQueue *queue = arg;
+    JobSystem *jobs = queue->jobs;
+    unsigned int seen = 0;
+
+    pthread_mutex_lock(&jobs->lock);
+    for (;;) {
+        while (jobs->running && jobs->generation == seen) pthread_cond_wait(&jobs->wake, &jobs->lock);
+        if (!jobs->running) break;
+        seen = jobs->generation;
+        pthread_mutex_unlock(&jobs->lock);
+
+        WorkUntilDry(jobs, queue->worker);
+
+        pthread_mutex_lock(&jobs->lock);
+    }
+    pthread_mutex_unlock(&jobs->lock);
+    return NULL;
+}
+#endif
+
+// ------------ API ------------
+void StartJobSystem(JobSystem *jobs, int threads) {
+    memset(jobs, 0, sizeof(*jobs));
+    if (threads <= 0) threads = CpuCount();
+    if (threads > JOB_MAX_THREADS) threads = JOB_MAX_THREADS;
+    jobs->threadCount = 1;
+
+#if defined(JOBS_THREADED)
+    pthread_mutex_init(&jobs->lock, NULL);
+    pthread_cond_init(&jobs->wake, NULL);
+    jobs->running = true;
+
+    for (int i = 0; i < JOB_MAX_THREADS; i++) {
+        jobs->queues[i].jobs = jobs;
+        jobs->queues[i].worker = i;
+    }
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&jobs->threads[i], NULL, WorkerMain, &jobs->queues[i]) != 0) break;
+        jobs->threadCount++;
+    }
+#else
+    (void)threads;
+#endif
+}
+
+void StopJobSystem(JobSystem *jobs) {
+#if defined(JOBS_THREADED)
+    pthread_mutex_lock(&jobs->lock);
+    jobs->running = false;
+    pthread_cond_broadcast(&jobs->wake);
+    pthread_mutex_unlock(&jobs->lock);
+
+    for (int i = 1; i < jobs->threadCount; i++) pthread_join(jobs->threads[i], NULL);
+    pthread_cond_destroy(&jobs->wake);
+    pthread_mutex_destroy(&jobs->lock);
+#endif
+    memset(jobs, 0, sizeof(*jobs));
+}
+
+void ParallelFor(JobSystem *jobs, int count, int grain, JobFunc func, void *context) {
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+    int batches = (count + grain - 1) / grain;
+
+    if (JobWorkerCount(jobs) == 1 || batches == 1) {
+        func(context, 0, count, 0);
+        return;
+    }
+
+#if defined(JOBS_THREADED)
+    jobs->func = func;
+    jobs->context = context;
+    jobs->count = count;
+    jobs->grain = grain;
+    __atomic_store_n(&jobs->pending, batches, __ATOMIC_RELAXED);
+
+    // Contiguous runs, so each worker starts on neighbouring memory
+    for (int w = 0; w < jobs->threadCount; w++) {
+        int begin = (int)((long long)batches * w / jobs->threadCount);
+        int end = (int)((long long)batches * (w + 1) / jobs->threadCount);
+        __atomic_store_n(&jobs->queues[w].range, PACK_RANGE(begin, end), __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_lock(&jobs->lock);
+    jobs->generation++;
+    pthread_cond_broadcast(&jobs->wake);
+    pthread_mutex_unlock(&jobs->lock);
+
+    WorkUntilDry(jobs, 0);
+    while (__atomic_load_n(&jobs->pending, __ATOMIC_ACQUIRE) > 0) sched_yield();
+#endif
+}
@@ -0,0 +1,63 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+
+// Builds without threads (PLATFORM_WEB) run every job on the calling thread
+#if !defined(PLATFORM_WEB)
+    #define JOBS_THREADED 1
+    #include <pthread.h>
+#endif
+
+#define JOB_MAX_THREADS 16
+
+// Runs batches [begin, end) of a ParallelFor() on worker (0 is the calling thread)
+typedef void (*JobFunc)(void *context, int begin, int end, int worker);
+
+struct JobSystem;
+
+// Each worker owns a range of batch indices packed into one 64-bit word (begin low, end high)
+// so the owner can take from the front and thieves can split off the back with a single CAS
+typedef struct {
+    unsigned long long range;
+    struct JobSystem  *jobs;
+    int   worker;
+    char  pad[64 - sizeof(unsigned long long) - sizeof(void *) - sizeof(int)];   // One queue per cache line
+} JobQueue;
+
+// Small fork-join scheduler with work stealing. ParallelFor() deals a loop's batches out
+// evenly, the calling thread works alongside the pool, and a worker that runs dry steals the
+// back half of the next worker's remaining range. Jobs must not depend on which worker or
+// in what order batches run; results that need an order are merged by the caller afterwards.
+// Workers point back at the JobSystem, so it must not move while started.
+typedef struct JobSystem {
+    int threadCount;          // Including the thread that calls ParallelFor()
+
+#if defined(JOBS_THREADED)
+    pthread_t       threads[JOB_MAX_THREADS];
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    bool            running;
+    unsigned int    generation;   // Bumped per ParallelFor(); sleeping workers wait for a new one
+
+    JobQueue  queues[JOB_MAX_THREADS];
+    JobFunc   func;
+    void     *context;
+    int       count;
+    int       grain;
+    int       pending;            // Batches not finished yet
+#endif
+} JobSystem;
+
+// threads <= 0 picks one per CPU; 1 runs everything inline
+void StartJobSystem(JobSystem *jobs, int threads);
+void StopJobSystem(JobSystem *jobs);
+
+// Calls func over [0, count) in batches of grain and returns when all have run. jobs may be
+// NULL, which runs the whole range inline as one call.
+void ParallelFor(JobSystem *jobs, int count, int grain, JobFunc func, void *context);
+
+int JobWorkerCount(const JobSystem *jobs);   // 1 when jobs is NULL
+int CpuCount(void);
+
+#endif // JOBS_H
@@ -0,0 +1,61 @@
+#include "mapfile.h"
+#include <string.h>
+
+// Kept out of the header so <windows.h> never meets raylib.h in the same translation unit
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+bool MapFile(MappedFile *file, const char *fileName) {
+    memset(file, 0, sizeof(*file));
+
+#if defined(_WIN32)
+    HANDLE fh = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (fh == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(fh, &size) || size.QuadPart == 0) { CloseHandle(fh); return false; }
+
+    HANDLE mapping = CreateFileMappingA(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(fh);    // The mapping keeps the file open
+    if (mapping == NULL) return false;
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) { CloseHandle(mapping); return false; }
+
+    file->data = view;
+    file->size = (size_t)size.QuadPart;
+    file->handle = mapping;
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+
+    void *view = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);          // The mapping keeps the file open
+    if (view == MAP_FAILED) return false;
+
+    file->data = view;
+    file->size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void UnmapFile(MappedFile *file) {
+    if (file->data == NULL) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(file->data);
+    CloseHandle(file->handle);
+#else
+    munmap((void *)file->data, file->size);
+#endif
+    memset(file, 0, sizeof(*file));
+}
@@ -0,0 +1,18 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// Read-only view of a whole file mapped into memory. Pages are faulted in by the OS on first
+// touch, so opening costs a couple of syscalls no matter how large the file is.
+typedef struct {
+    const unsigned char *data;
+    size_t size;
+    void  *handle;     // Platform mapping handle; NULL on POSIX
+} MappedFile;
+
+bool MapFile(MappedFile *file, const char *fileName);
+void UnmapFile(MappedFile *file);
+
+#endif // MAPFILE_H
@@ -0,0 +1,260 @@
+#include "obstacles.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PUSH_OUT_MAX  8    // Rocks one circle is pushed out of per call
+
+void InitObstacleMap(ObstacleMap *map) {
+    *map = (ObstacleMap){ 0 };
+}
+
+void UnloadObstacleMap(ObstacleMap *map) {
+    free(map->rects);
+    free(map->samples);
+    free(map->active);
+    free(map->grid);
+    UnloadStaticBvh(&map->tree);
+    *map = (ObstacleMap){ 0 };
+}
+
+void ClearObstacles(ObstacleMap *map) {
+    map->count = 0;
+    map->tree.nodeCount = 0;
+    map->version++;
+}
+
+// ------------ Placement ------------
+typedef struct {
+    ObstacleMap *map;
+    RandomStream *random;
+    Vector2   origin;       // Lowest sample centre allowed
+    Vector2   extent;       // Size of the region centres may take
+    Vector2   size;
+    float     spacing;
+    float     cellSize;     // spacing / sqrt(2): one sample per cell at most
+    int       cols, rows;
+    Rectangle keepClear;
+    int       sampleCount;
+    int       activeCount;
+} Placement;
+
+static int GridCell(const Placement *p, Vector2 point) {
+    int cx = (int)((point.x - p->origin.x) / p->cellSize);
+    int cy = (int)((point.y - p->origin.y) / p->cellSize);
+    if (cx >= p->cols) cx = p->cols - 1;
+    if (cy >= p->rows) cy = p->rows - 1;
+    return cy * p->cols + cx;
+}
+
+static bool Fits(const Placement *p, Vector2 point) {
+    if (point.x < p->origin.x || point.y < p->origin.y) return false;
+    if (point.x > p->origin.x + p->extent.x || point.y > p->origin.y + p->extent.y) return false;
+
+    Rectangle rect = { point.x - p->size.x/2.0f, point.y - p->size.y/2.0f, p->size.x, p->size.y };
+    if (CheckCollisionRecs(rect, p->keepClear)) return false;
+
+    // Anything closer than spacing sits within two cells
+    int cell = GridCell(p, point), cx = cell % p->cols, cy = cell / p->cols;
+    for (int y = cy - 2; y <= cy + 2; y++) {
+        for (int x = cx - 2; x <= cx + 2; x++) {
+            if (x < 0 || y < 0 || x >= p->cols || y >= p->rows) continue;
+            int other = p->map->grid[y * p->cols + x];
+            if (other < 0) continue;
+            float dx = p->map->samples[other].x - point.x, dy = p->map->samples[other].y - point.y;
+            if (dx*dx + dy*dy < p->spacing * p->spacing) return false;
+        }
+    }
+    return true;
+}
+
+static void AddSample(Placement *p, Vector2 point) {
+    ObstacleMap *map = p->map;
+    map->samples[p->sampleCount] = point;
+    map->grid[GridCell(p, point)] = p->sampleCount;
+    map->active[p->activeCount++] = p->sampleCount;
+    p->sampleCount++;
+}
+
+// Grows the set from the active samples until every one is retired. Each round adds a sample
+// (one per grid cell at most) or retires one, so this ends.
+static void GrowSamples(Placement *p) {
+    ObstacleMap *map = p->map;
+    while (p->activeCount > 0) {
+        int a = RandomInt(p->random, 0, p->activeCount - 1);
+        Vector2 around = map->samples[map->active[a]];
+        bool added = false;
+
+        for (int attempt = 0; attempt < PLACEMENT_ATTEMPTS && !added; attempt++) {
+            // Uniform over the square, kept inside the annulus [spacing, 2 spacing)
+            float dx = RandomFloat(p->random, -2.0f, 2.0f) * p->spacing;
+            float dy = RandomFloat(p->random, -2.0f, 2.0f) * p->spacing;
+            float d2 = dx*dx + dy*dy;
+            if (d2 < p->spacing * p->spacing || d2 >= 4.0f * p->spacing * p->spacing) continue;
+
+            Vector2 candidate = { around.x + dx, around.y + dy };
+            if (Fits(p, candidate)) {
+                AddSample(p, candidate);
+                added = true;
+            }
+        }
+        if (!added) map->active[a] = map->active[--p->activeCount];
+    }
+}
+
+// Seeds sweep the grid from a random cell, one try per empty cell, so every piece the clearance
+// box cuts the free space into gets a seed of its own and the sweep stays bounded
+static void RunBridson(Placement *p) {
+    int cells = p->cols * p->rows, start = RandomInt(p->random, 0, cells - 1);
+    for (int k = 0; k < cells; k++) {
+        int cell = (start + k) % cells;
+        if (p->map->grid[cell] >= 0) continue;
+
+        Vector2 seed = {
+            p->origin.x + ((float)(cell % p->cols) + RandomFloat(p->random, 0.0f, 1.0f)) * p->cellSize,
+            p->origin.y + ((float)(cell / p->cols) + RandomFloat(p->random, 0.0f, 1.0f)) * p->cellSize
+        };
+        if (!Fits(p, seed)) continue;
+        AddSample(p, seed);
+        GrowSamples(p);
+    }
+}
+
+int PlaceObstacles(ObstacleMap *map, RandomStream *random, Rectangle area, Vector2 size, float spacing, Rectangle keepClear, int count) {
+    ClearObstacles(map);
+
+    Placement p = { 0 };
+    p.map = map;
+    p.random = random;
+    p.origin = (Vector2){ area.x + size.x/2.0f, area.y + size.y/2.0f };
+    p.extent = (Vector2){ area.width - size.x, area.height - size.y };
+    p.size = size;
+    p.spacing = spacing;
+    p.keepClear = keepClear;
+    if (count <= 0 || spacing <= 0.0f || p.extent.x < 0.0f || p.extent.y < 0.0f) return 0;
+
+    p.cellSize = spacing / sqrtf(2.0f);
+    p.cols = (int)(p.extent.x / p.cellSize) + 1;
+    p.rows = (int)(p.extent.y / p.cellSize) + 1;
+    int cells = p.cols * p.rows;
+    if (cells > map->gridCapacity) {
+        map->grid = realloc(map->grid, cells * sizeof(int));
+        map->samples = realloc(map->samples, cells * sizeof(Vector2));
+        map->active = realloc(map->active, cells * sizeof(int));
+        map->gridCapacity = map->sampleCapacity = cells;
+    }
+    // Tight maps sometimes pack badly; another pass usually finds the room
+    for (int pass = 0; pass < PLACEMENT_PASSES && p.sampleCount < count; pass++) {
+        for (int i = 0; i < cells; i++) map->grid[i] = -1;
+        p.sampleCount = 0;
+        RunBridson(&p);
+    }
+
+    // A random subset of a Poisson-disk set keeps its spacing
+    int placed = (p.sampleCount < count) ? p.sampleCount : count;
+    if (placed > map->capacity) {
+        map->rects = realloc(map->rects, placed * sizeof(Rectangle));
+        map->capacity = placed;
+    }
+    for (int i = 0; i < placed; i++) {
+        int j = RandomInt(random, i, p.sampleCount - 1);
+        Vector2 chosen = map->samples[j];
+        map->samples[j] = map->samples[i];
+        map->samples[i] = chosen;
+        map->rects[i] = (Rectangle){ chosen.x - size.x/2.0f, chosen.y - size.y/2.0f, size.x, size.y };
+    }
+    map->count = placed;
+    BuildStaticBvh(&map->tree, map->rects, map->count);
+    return placed;
+}
+
+void SetObstacles(ObstacleMap *map, const Rectangle *rects, int count) {
+    if (count == map->count && (count == 0 || memcmp(rects, map->rects, count * sizeof(Rectangle)) == 0)) return;
+
+    ClearObstacles(map);
+    if (count > map->capacity) {
+        map->rects = realloc(map->rects, count * sizeof(Rectangle));
+        map->capacity = count;
+    }
+    if (count > 0) memcpy(map->rects, rects, count * sizeof(Rectangle));
+    map->count = count;
+    BuildStaticBvh(&map->tree, map->rects, map->count);
+}
+
+// ------------ Queries ------------
+bool ObstacleHitsRect(const ObstacleMap *map, Rectangle rect) {
+    return map->count > 0 && BvhAnyRect(&map->tree, map->rects, rect) >= 0;
+}
+
+bool ObstacleHitsCircle(const ObstacleMap *map, Vector2 center, float radius) {
+    return map->count > 0 && BvhAnyCircle(&map->tree, map->rects, center, radius) >= 0;
+}
+
+float ObstacleSweepCircle(const ObstacleMap *map, Vector2 from, Vector2 to, float radius) {
+    float time = -1.0f;
+    if (map->count > 0) BvhSweepCircle(&map->tree, map->rects, from, to, radius, &time);
+    return time;
+}
+
+float ObstacleSweepRect(const ObstacleMap *map, Rectangle rect, Vector2 delta) {
+    float time = -1.0f;
+    if (map->count > 0) BvhSweepRect(&map->tree, map->rects, rect, delta, &time);
+    return time;
+}
+
+Vector2 PushOutOfObstacles(const ObstacleMap *map, Vector2 center, float radius) {
+    if (map->count == 0) return center;
+
+    int hits[PUSH_OUT_MAX];
+    Rectangle box = { center.x - radius, center.y - radius, 2.0f * radius, 2.0f * radius };
+    int found = QueryStaticBvh(&map->tree, map->rects, box, hits, PUSH_OUT_MAX);
+    if (found > PUSH_OUT_MAX) found = PUSH_OUT_MAX;
+
+    for (int i = 0; i < found; i++) {
+        Rectangle r = map->rects[hits[i]];
+        float left = r.x, right = r.x + r.width, top = r.y, bottom = r.y + r.height;
+        float nx = (center.x < left) ? left : (center.x > right) ? right : center.x;
+        float ny = (center.y < top) ? top : (center.y > bottom) ? bottom : center.y;
+        float dx = center.x - nx, dy = center.y - ny, d2 = dx*dx + dy*dy;
+        if (d2 >= radius * radius) continue;
+
+        if (d2 > 0.0f) {
+            float d = sqrtf(d2);
+            center.x = nx + dx / d * radius;
+            center.y = ny + dy / d * radius;
+        } else {
+            // Centre inside the rock: out through the nearest edge
+            float toLeft = center.x - left, toRight = right - center.x, toTop = center.y - top, toBottom = bottom - center.y;
+            float best = fminf(fminf(toLeft, toRight), fminf(toTop, toBottom));
+            if (best == toLeft) center.x = left - radius;
+            else if (best == toRight) center.x = right + radius;
+            else if (best == toTop) center.y = top - radius;
+            else center.y = bottom + radius;
+        }
+    }
+    return center;
+}
+
+Vector2 PushRectOutOfObstacles(const ObstacleMap *map, Rectangle rect) {
+    Vector2 offset = { 0, 0 };
+    if (map->count == 0) return offset;
+
+    int hits[PUSH_OUT_MAX];
+    int found = QueryStaticBvh(&map->tree, map->rects, rect, hits, PUSH_OUT_MAX);
+    if (found > PUSH_OUT_MAX) found = PUSH_OUT_MAX;
+
+    for (int i = 0; i < found; i++) {
+        Rectangle r = map->rects[hits[i]];
+        Rectangle moved = { rect.x + offset.x, rect.y + offset.y, rect.width, rect.height };
+        if (!CheckCollisionRecs(moved, r)) continue;
+
+        float toLeft = moved.x + moved.width - r.x, toRight = r.x + r.width - moved.x;
+        float toTop = moved.y + moved.height - r.y, toBottom = r.y + r.height - moved.y;
+        float best = fminf(fminf(toLeft, toRight), fminf(toTop, toBottom));
+        if (best == toLeft) offset.x -= toLeft;
+        else if (best == toRight) offset.x += toRight;
+        else if (best == toTop) offset.y -= toTop;
+        else offset.y += toBottom;
+    }
+    return offset;
+}
@@ -0,0 +1,60 @@
+#ifndef OBSTACLES_H
+#define OBSTACLES_H
+
+#include "raylib.h"
+#include "bvh.h"
+#include "rng.h"
+#include <stdbool.h>
+
+#define PLACEMENT_ATTEMPTS  30    // Candidates tried around each sample before it is retired
+#define PLACEMENT_PASSES    3     // Fresh samplings tried when one comes up short of the count
+
+// The rocks of one map: a compact rectangle array and the static tree over it, rebuilt
+// whenever the map changes. Placement scratch is kept so the next map reuses it.
+typedef struct {
+    Rectangle *rects;
+    int        count;
+    int        capacity;
+    unsigned int version;     // Bumped on every change, so caches built over the rocks know
+    StaticBvh  tree;
+
+    Vector2   *samples;
+    int       *active;
+    int       *grid;
+    int        sampleCapacity;
+    int        gridCapacity;
+} ObstacleMap;
+
+void InitObstacleMap(ObstacleMap *map);
+void UnloadObstacleMap(ObstacleMap *map);
+void ClearObstacles(ObstacleMap *map);
+
+// Replaces the map with up to count rocks of size lying inside area, none overlapping
+// keepClear. Rock centres are Poisson-disk samples (Bridson) at least spacing apart, so
+// spacing of at least the rock diagonal keeps rocks from overlapping each other. Every sample
+// gets a fixed number of candidates, the grid holds one sample per cell and a short sampling
+// is retried a fixed number of times, so placement always finishes. When more samples fit
+// than count, a random subset is kept. Every draw comes from random. Returns how many rocks
+// were placed; fewer than count when the area is full.
+int PlaceObstacles(ObstacleMap *map, RandomStream *random, Rectangle area, Vector2 size, float spacing, Rectangle keepClear, int count);
+
+// Replaces the map with exactly these rocks, as when a saved world is restored. Leaves the map
+// (and its version) alone when it already holds them.
+void SetObstacles(ObstacleMap *map, const Rectangle *rects, int count);
+
+bool ObstacleHitsRect(const ObstacleMap *map, Rectangle rect);
+bool ObstacleHitsCircle(const ObstacleMap *map, Vector2 center, float radius);
+
+// Earliest time (a fraction of the move, see sweep.h) a moving circle or rectangle touches a
+// rock, or -1 when it clears them all
+float ObstacleSweepCircle(const ObstacleMap *map, Vector2 from, Vector2 to, float radius);
+float ObstacleSweepRect(const ObstacleMap *map, Rectangle rect, Vector2 delta);
+
+// Moves a circle out of any rock it overlaps, along the shortest way out
+Vector2 PushOutOfObstacles(const ObstacleMap *map, Vector2 center, float radius);
+
+// Offset that moves a rectangle out of the rocks it overlaps, each along the axis with the
+// shortest way out. Leaving one rock can mean entering another, so check again if it matters.
+Vector2 PushRectOutOfObstacles(const ObstacleMap *map, Rectangle rect);
+
+#endif // OBSTACLES_H
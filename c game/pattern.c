@@ -0,0 +1,55 @@
+#include "pattern.h"
+#include <math.h>
+#include <string.h>
+
+static const BulletPattern bulletPatterns[] = {
+    //  name       kind             count spread  spin  speed  lifetime interval
+    { "shot",    PATTERN_SPREAD,     1,   0.0f,  0.0f, 400.0f, 10.0f, 0.25f },   // The player's gun
+    { "triple",  PATTERN_SPREAD,     3,  30.0f,  0.0f, 400.0f, 10.0f, 0.25f },
+    { "ring",    PATTERN_RING,      24,   0.0f,  0.0f, 200.0f,  4.0f, 0.50f },
+    { "spiral",  PATTERN_SPIRAL,     6,   0.0f, 11.0f, 250.0f,  4.0f, 0.05f },
+    { "aimed",   PATTERN_AIMED,      5,  20.0f,  0.0f, 300.0f,  4.0f, 0.30f },
+    { "storm",   PATTERN_SPIRAL,   128,   0.0f,  3.0f,  60.0f,  6.0f, 0.10f },   // Stress tests: ~6.4k live per emitter
+};
+
+#define PATTERN_COUNT ((int)(sizeof(bulletPatterns)/sizeof(bulletPatterns[0])))
+
+const BulletPattern *FindBulletPattern(const char *name) {
+    for (int i = 0; i < PATTERN_COUNT; i++) {
+        if (strcmp(bulletPatterns[i].name, name) == 0) return &bulletPatterns[i];
+    }
+    return NULL;
+}
+
+int BulletPatternId(const BulletPattern *pattern) {
+    return (pattern != NULL) ? (int)(pattern - bulletPatterns) : -1;
+}
+
+const BulletPattern *BulletPatternById(int id) {
+    return (id >= 0 && id < PATTERN_COUNT) ? &bulletPatterns[id] : NULL;
+}
+
+int PatternVolley(const BulletPattern *pattern, Vector2 facing, Vector2 toTarget, int volley, Vector2 *velocities) {
+    int count = (pattern->count < PATTERN_MAX_VOLLEY) ? pattern->count : PATTERN_MAX_VOLLEY;
+
+    Vector2 base = facing;
+    if (pattern->kind == PATTERN_AIMED) {
+        float length = sqrtf(toTarget.x*toTarget.x + toTarget.y*toTarget.y);
+        if (length > 0.0f) base = (Vector2){ toTarget.x / length, toTarget.y / length };
+    }
+
+    for (int i = 0; i < count; i++) {
+        // Offset from base in degrees; an offset of exactly 0 keeps base exact
+        float offset = 0.0f;
+        switch (pattern->kind) {
+            case PATTERN_SPREAD:
+            case PATTERN_AIMED:  offset = (count > 1) ? pattern->spread * ((float)i / (float)(count - 1) - 0.5f) : 0.0f; break;
+            case PATTERN_RING:   offset = 360.0f * (float)i / (float)count; break;
+            case PATTERN_SPIRAL: offset = fmodf(360.0f * (float)i / (float)count + pattern->spin * (float)volley, 360.0f); break;
+        }
+
+        float c = cosf(offset * DEG2RAD), s = sinf(offset * DEG2RAD);
+        velocities[i] = (Vector2){ (base.x * c - base.y * s) * pattern->speed, (base.x * s + base.y * c) * pattern->speed };
+    }
+    return count;
+}
@@ -0,0 +1,48 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include "raylib.h"
+
+#define PATTERN_MAX_VOLLEY  256    // Bullets one volley may fire
+
+typedef enum {
+    PATTERN_SPREAD,     // Fan of count bullets across spread degrees, centred on the facing
+    PATTERN_RING,       // count bullets evenly around the circle, the first along the facing
+    PATTERN_SPIRAL,     // A ring that turns spin degrees further every volley
+    PATTERN_AIMED       // Fan like SPREAD, centred on the direction to the target
+} PatternKind;
+
+// One volley shape and how fast it repeats. Patterns are plain data: the table in pattern.c
+// holds the ones the game and tools pick by name.
+typedef struct {
+    const char *name;
+    PatternKind kind;
+    int   count;        // Bullets per volley, up to PATTERN_MAX_VOLLEY
+    float spread;       // SPREAD, AIMED: degrees from the first bullet to the last
+    float spin;         // SPIRAL: degrees added per volley
+    float speed;        // Pixels per second
+    float lifetime;     // Seconds a bullet lives unless it leaves the playfield first
+    float interval;     // Seconds between an emitter's volleys
+} BulletPattern;
+
+// A pattern firing on its own from a fixed spot
+typedef struct {
+    const BulletPattern *pattern;
+    Vector2 position;
+    Vector2 facing;     // Unit vector the pattern is laid out around
+    float   timer;      // Seconds until the next volley
+    int     volleys;    // Fired so far; turns the spiral
+} Emitter;
+
+const BulletPattern *FindBulletPattern(const char *name);   // NULL when no pattern has that name
+
+// Position in the table, for saving a reference to a pattern; -1 for NULL
+int BulletPatternId(const BulletPattern *pattern);
+const BulletPattern *BulletPatternById(int id);             // NULL when out of range
+
+// Velocities of volley number `volley` of pattern, laid out around facing (a unit vector) or,
+// for AIMED, around toTarget. Writes pattern->count velocities (capped at PATTERN_MAX_VOLLEY)
+// and returns how many.
+int PatternVolley(const BulletPattern *pattern, Vector2 facing, Vector2 toTarget, int volley, Vector2 *velocities);
+
+#endif // PATTERN_H
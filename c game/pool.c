@@ -0,0 +1,74 @@
+#include "pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+void InitEntityPool(EntityPool *pool, Arena *arena) {
+    memset(pool, 0, sizeof(*pool));
+    pool->arena = arena;
+}
+
+void UnloadEntityPool(EntityPool *pool) {
+    free(pool->chunks);
+    memset(pool, 0, sizeof(*pool));
+}
+
+int GrowEntityPool(EntityPool *pool) {
+    if (pool->chunkCount == pool->chunkTableSize) {
+        pool->chunkTableSize = (pool->chunkTableSize > 0) ? pool->chunkTableSize * 2 : 4;
+        pool->chunks = realloc(pool->chunks, pool->chunkTableSize * sizeof(PoolChunk *));
+    }
+
+    // New slots go on the free stack in ascending order; the stack region [count, capacity)
+    // simply extends into the new chunk
+    PoolChunk *chunk = ArenaAlloc(pool->arena, sizeof(PoolChunk));
+    int base = pool->capacity;
+    for (int k = 0; k < ENTITY_CHUNK_SIZE; k++) {
+        chunk->denseToSlot[k] = base + k;
+        chunk->slotToDense[k] = base + k;
+    }
+
+    int index = pool->chunkCount++;
+    pool->chunks[index] = chunk;
+    pool->capacity += ENTITY_CHUNK_SIZE;
+    pool->growths++;
+    return index;
+}
+
+int SpawnEntity(EntityPool *pool) {
+    if (pool->count >= pool->capacity) return -1;
+    int dense = pool->count++;
+    if (pool->count > pool->peakCount) pool->peakCount = pool->count;
+    return dense;
+}
+
+int RemoveEntity(EntityPool *pool, int dense) {
+    int last = pool->count - 1;
+    int slot = POOL_DENSE_TO_SLOT(pool, dense);
+    int movedSlot = POOL_DENSE_TO_SLOT(pool, last);
+
+    // The last live entity fills the hole and the freed slot lands on top of the free stack
+    POOL_DENSE_TO_SLOT(pool, dense) = movedSlot;
+    POOL_SLOT_TO_DENSE(pool, movedSlot) = dense;
+    POOL_DENSE_TO_SLOT(pool, last) = slot;
+    POOL_SLOT_TO_DENSE(pool, slot) = last;
+    POOL_GENERATION(pool, slot)++;
+    pool->count--;
+
+    return last;
+}
+
+void ClearEntityPool(EntityPool *pool) {
+    for (int i = 0; i < pool->count; i++) POOL_GENERATION(pool, POOL_DENSE_TO_SLOT(pool, i))++;
+    pool->count = 0;
+}
+
+EntityHandle GetEntityHandle(const EntityPool *pool, int dense) {
+    int slot = POOL_DENSE_TO_SLOT(pool, dense);
+    return (EntityHandle){ slot, POOL_GENERATION(pool, slot) };
+}
+
+int ResolveEntityHandle(const EntityPool *pool, EntityHandle handle) {
+    if (handle.slot < 0 || handle.slot >= pool->capacity) return -1;
+    if (POOL_GENERATION(pool, handle.slot) != handle.generation) return -1;
+    return EntitySlotToDense(pool, handle.slot);
+}
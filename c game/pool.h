@@ -0,0 +1,79 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "arena.h"
+#include <stdbool.h>
+
+// Entities live in fixed-size chunks carved from an arena, so capacity can grow while the
+// game runs without moving anything already spawned
+#define ENTITY_CHUNK_SHIFT  8
+#define ENTITY_CHUNK_SIZE   (1 << ENTITY_CHUNK_SHIFT)
+#define ENTITY_CHUNK_MASK   (ENTITY_CHUNK_SIZE - 1)
+
+// Bookkeeping for a packed entity array. Live entities always occupy dense indices
+// [0, count), so update and draw loops touch only live data. Each entity also owns a stable
+// slot; a handle pairs that slot with the generation it was spawned in, so a handle that
+// outlives its entity is detected instead of silently pointing at whatever reused the slot.
+//
+// The pool only tracks indices: callers keep their own structure-of-arrays chunks (one per
+// pool chunk) and move element `last` into `dense` when RemoveEntity() reports a swap.
+typedef struct {
+    int slot;
+    unsigned int generation;
+} EntityHandle;
+
+typedef struct {
+    int denseToSlot[ENTITY_CHUNK_SIZE];         // Live slots below count, free-slot stack above
+    int slotToDense[ENTITY_CHUNK_SIZE];
+    unsigned int generation[ENTITY_CHUNK_SIZE]; // Bumped every time a slot is freed
+} PoolChunk;
+
+typedef struct {
+    int count;                  // Live entities, packed at dense [0, count)
+    int capacity;               // chunkCount * ENTITY_CHUNK_SIZE
+    PoolChunk **chunks;
+    int chunkCount;
+    int chunkTableSize;         // Chunk pointer slots allocated; the table is the only thing that reallocates
+    Arena *arena;
+
+    // Sizing stats for tuning the initial reserve from real sessions
+    int peakCount;
+    int growths;                // Chunks added after InitEntityPool()
+} EntityPool;
+
+#define POOL_DENSE_TO_SLOT(pool, i)  ((pool)->chunks[(i) >> ENTITY_CHUNK_SHIFT]->denseToSlot[(i) & ENTITY_CHUNK_MASK])
+#define POOL_SLOT_TO_DENSE(pool, s)  ((pool)->chunks[(s) >> ENTITY_CHUNK_SHIFT]->slotToDense[(s) & ENTITY_CHUNK_MASK])
+#define POOL_GENERATION(pool, s)     ((pool)->chunks[(s) >> ENTITY_CHUNK_SHIFT]->generation[(s) & ENTITY_CHUNK_MASK])
+
+// Starts empty; the owner grows it (and its data chunks) to the initial reserve
+void InitEntityPool(EntityPool *pool, Arena *arena);
+void UnloadEntityPool(EntityPool *pool);   // Chunks belong to the arena; only the table is freed
+
+// Adds one chunk of slots and returns its index; the caller adds the matching data chunk
+int GrowEntityPool(EntityPool *pool);
+
+// O(1): pops a free slot and returns its dense index (always the old count), or -1 when
+// every chunk is full and the caller has to grow first
+int SpawnEntity(EntityPool *pool);
+
+// O(1) swap-remove: frees the entity at `dense` and returns the dense index of the element
+// that must be moved into `dense` (equal to `dense` when it was already last)
+int RemoveEntity(EntityPool *pool, int dense);
+
+// Frees every live entity, invalidating all outstanding handles
+void ClearEntityPool(EntityPool *pool);
+
+EntityHandle GetEntityHandle(const EntityPool *pool, int dense);
+int ResolveEntityHandle(const EntityPool *pool, EntityHandle handle);   // Dense index or -1 if stale
+
+static inline int EntityDenseToSlot(const EntityPool *pool, int dense) {
+    return POOL_DENSE_TO_SLOT(pool, dense);
+}
+
+// Dense index of a live slot, or -1 if the slot is free
+static inline int EntitySlotToDense(const EntityPool *pool, int slot) {
+    int dense = POOL_SLOT_TO_DENSE(pool, slot);
+    return (dense < pool->count) ? dense : -1;
+}
+
+#endif // POOL_H
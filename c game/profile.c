@@ -0,0 +1,176 @@
+#include "profile.h"
+
+#if defined(PROFILER)
+
+#include "raylib.h"
+#include "timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_EVENTS_PER_FRAME  64    // Phases can run more than once per frame
+#define TRACE_EVENTS            (PROFILE_TRACE_FRAMES * TRACE_EVENTS_PER_FRAME)
+
+static const char *phaseNames[PROFILE_PHASE_COUNT] = {
+    "streaming", "input", "bullets", "spawn", "elixir", "steer", "collide", "bowling", "pins", "draw", "present"
+};
+
+// Trace rows: phases by the thread they run on, and whole frames
+enum { TRACE_TID_RENDER = 1, TRACE_TID_FRAMES = 2, TRACE_TID_SIM = 3 };
+
+static int PhaseThread(int phase) {
+    if (phase == PROFILE_PHASE_COUNT) return TRACE_TID_FRAMES;
+    return (phase == PROFILE_STREAMING || phase == PROFILE_DRAW || phase == PROFILE_PRESENT) ? TRACE_TID_RENDER : TRACE_TID_SIM;
+}
+
+typedef struct {
+    unsigned char phase;      // PROFILE_PHASE_COUNT marks a whole frame
+    double start;             // Microseconds on the monotonic clock
+    double duration;
+} TraceEvent;
+
+// Phases are timed on the thread that runs them and folded into frames on the render thread,
+// so everything both sides touch is atomic: per-frame totals in nanoseconds, the event cursor
+// and the frames left to trace. begun[] is only ever written by a phase's own thread. The event
+// buffer is fixed for the program's life, so a simulation step that saw the last trace still
+// running can only ever write inside it.
+typedef struct {
+    double begun[PROFILE_PHASE_COUNT];
+    long long frameTotal[PROFILE_PHASE_COUNT];
+    double frameStart;
+
+    // Rolling window, milliseconds; the last slot holds whole frames
+    float history[PROFILE_PHASE_COUNT + 1][PROFILE_WINDOW];
+    int   frames;
+    int   cursor;
+    bool  overlay;
+
+    TraceEvent events[TRACE_EVENTS];
+    int   eventCount;
+    int   traceFramesLeft;
+    char  traceFile[256];
+} Profiler;
+
+static Profiler profiler = { 0 };
+
+static double NowMicros(void) {
+    return NowSeconds() * 1e6;
+}
+
+static void RecordEvent(int phase, double start, double duration) {
+    if (__atomic_load_n(&profiler.traceFramesLeft, __ATOMIC_ACQUIRE) <= 0) return;
+    int index = __atomic_fetch_add(&profiler.eventCount, 1, __ATOMIC_RELAXED);
+    if (index < TRACE_EVENTS) profiler.events[index] = (TraceEvent){ (unsigned char)phase, start, duration };
+}
+
+void ProfileBegin(ProfilePhase phase) {
+    profiler.begun[phase] = NowMicros();
+}
+
+void ProfileEnd(ProfilePhase phase) {
+    double now = NowMicros();
+    __atomic_fetch_add(&profiler.frameTotal[phase], (long long)((now - profiler.begun[phase]) * 1000.0), __ATOMIC_RELAXED);
+    RecordEvent(phase, profiler.begun[phase], now - profiler.begun[phase]);
+}
+
+// ------------ Trace export ------------
+static void WriteTrace(void) {
+    FILE *file = fopen(profiler.traceFile, "w");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "PROFILER: Could not write %s", profiler.traceFile);
+        return;
+    }
+
+    // Complete ("X") events, one row per thread; whole frames get their own row
+    int count = __atomic_load_n(&profiler.eventCount, __ATOMIC_RELAXED);
+    if (count > TRACE_EVENTS) count = TRACE_EVENTS;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"render\"}},\n", TRACE_TID_RENDER);
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"frames\"}},\n", TRACE_TID_FRAMES);
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"simulation\"}}", TRACE_TID_SIM);
+    for (int i = 0; i < count; i++) {
+        const TraceEvent *e = &profiler.events[i];
+        bool frame = (e->phase == PROFILE_PHASE_COUNT);
+        fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                frame ? "frame" : phaseNames[e->phase], PhaseThread(e->phase), e->start, e->duration);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+
+    TraceLog(LOG_INFO, "PROFILER: Wrote %d events to %s", count, profiler.traceFile);
+}
+
+void StartProfilerTrace(const char *fileName, int frames) {
+    if (profiler.traceFramesLeft > 0 || frames <= 0) return;
+    if (frames > PROFILE_TRACE_FRAMES) frames = PROFILE_TRACE_FRAMES;
+
+    __atomic_store_n(&profiler.eventCount, 0, __ATOMIC_RELAXED);
+    snprintf(profiler.traceFile, sizeof(profiler.traceFile), "%s", fileName);
+    __atomic_store_n(&profiler.traceFramesLeft, frames, __ATOMIC_RELEASE);
+    TraceLog(LOG_INFO, "PROFILER: Tracing the next %d frames", frames);
+}
+
+// ------------ Frames ------------
+void ProfileFrame(void) {
+    double now = NowMicros();
+    if (profiler.frameStart == 0.0) profiler.frameStart = now;
+
+    for (int p = 0; p < PROFILE_PHASE_COUNT; p++) {
+        profiler.history[p][profiler.cursor] = (float)(__atomic_exchange_n(&profiler.frameTotal[p], 0, __ATOMIC_RELAXED) / 1e6);
+    }
+    profiler.history[PROFILE_PHASE_COUNT][profiler.cursor] = (float)((now - profiler.frameStart) / 1000.0);
+    profiler.cursor = (profiler.cursor + 1) % PROFILE_WINDOW;
+    if (profiler.frames < PROFILE_WINDOW) profiler.frames++;
+
+    if (profiler.traceFramesLeft > 0) {
+        RecordEvent(PROFILE_PHASE_COUNT, profiler.frameStart, now - profiler.frameStart);
+        if (__atomic_sub_fetch(&profiler.traceFramesLeft, 1, __ATOMIC_ACQ_REL) == 0) WriteTrace();
+    }
+    profiler.frameStart = now;
+}
+
+// ------------ Overlay ------------
+void ToggleProfilerOverlay(void) {
+    profiler.overlay = !profiler.overlay;
+}
+
+static int CompareFloats(const void *a, const void *b) {
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+static void Percentiles(const float *history, int count, float *p50, float *p95, float *p99) {
+    float sorted[PROFILE_WINDOW];
+    memcpy(sorted, history, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), CompareFloats);
+    *p50 = sorted[(count - 1) * 50 / 100];
+    *p95 = sorted[(count - 1) * 95 / 100];
+    *p99 = sorted[(count - 1) * 99 / 100];
+}
+
+void DrawProfilerOverlay(int x, int y) {
+    if (!profiler.overlay || profiler.frames == 0) return;
+
+    // raylib's default font is proportional, so every column gets its own x
+    const int rowHeight = 14, fontSize = 10;
+    const int columns[4] = { x + 6, x + 100, x + 160, x + 220 };
+    DrawRectangle(x, y, 280, (PROFILE_PHASE_COUNT + 2) * rowHeight + 8, Fade(BLACK, 0.75f));
+    DrawText(TextFormat("ms, %d frames", profiler.frames), columns[0], y + 4, fontSize, LIGHTGRAY);
+    DrawText("p50", columns[1], y + 4, fontSize, LIGHTGRAY);
+    DrawText("p95", columns[2], y + 4, fontSize, LIGHTGRAY);
+    DrawText("p99", columns[3], y + 4, fontSize, LIGHTGRAY);
+
+    for (int p = 0; p <= PROFILE_PHASE_COUNT; p++) {
+        float p50, p95, p99;
+        Percentiles(profiler.history[p], profiler.frames, &p50, &p95, &p99);
+
+        int rowY = y + 4 + (p + 1) * rowHeight;
+        Color color = (p == PROFILE_PHASE_COUNT) ? YELLOW : (p99 > 4.0f) ? ORANGE : RAYWHITE;   // A quarter of a 60 Hz frame
+        DrawText((p == PROFILE_PHASE_COUNT) ? "frame" : phaseNames[p], columns[0], rowY, fontSize, color);
+        DrawText(TextFormat("%.3f", p50), columns[1], rowY, fontSize, color);
+        DrawText(TextFormat("%.3f", p95), columns[2], rowY, fontSize, color);
+        DrawText(TextFormat("%.3f", p99), columns[3], rowY, fontSize, color);
+    }
+}
+
+#endif // PROFILER
@@ -0,0 +1,59 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+
+// Frame profiler: per-phase timers folded into rolling percentiles, an on-screen overlay and
+// Chrome trace-event export (chrome://tracing, ui.perfetto.dev). Only built with -DPROFILER
+// (make PROFILER=TRUE); otherwise every macro below expands to nothing and no timer is read.
+
+#define PROFILE_WINDOW  240    // Frames the percentiles are taken over
+#define PROFILE_TRACE_FRAMES  600    // Most frames one trace records
+
+// Each phase runs on one thread only: streaming, draw and present on the render thread, the
+// rest inside StepWorld() on the simulation thread. A frame's row sums the steps that finished
+// during it, so it reads zero in frames that took no step.
+typedef enum {
+    PROFILE_STREAMING,    // Asset pump, scene references, atlas rebuild
+    PROFILE_INPUT,        // Applying held buttons to the player
+    PROFILE_BULLETS,      // Move, cull and rehash
+    PROFILE_SPAWN,
+    PROFILE_ELIXIR,
+    PROFILE_STEER,
+    PROFILE_COLLIDE,
+    PROFILE_BOWLING,      // Aim and charge
+    PROFILE_PINS,         // Ball flight and pin physics
+    PROFILE_DRAW,
+    PROFILE_PRESENT,      // EndDrawing(): buffer swap and the frame limiter
+    PROFILE_PHASE_COUNT
+} ProfilePhase;
+
+#if defined(PROFILER)
+
+void ProfileBegin(ProfilePhase phase);
+void ProfileEnd(ProfilePhase phase);
+void ProfileFrame(void);                    // Once per frame on the render thread, after the last phase
+
+void ToggleProfilerOverlay(void);
+void DrawProfilerOverlay(int x, int y);     // No-op while hidden
+
+// Records every phase of the next frames (at most PROFILE_TRACE_FRAMES), then writes them out
+// as trace events
+void StartProfilerTrace(const char *fileName, int frames);
+
+// Wraps the following statement or block; a break or return out of it skips the end mark
+#define PROFILE_SCOPE(phase)    for (int profileOnce_ = (ProfileBegin(phase), 1); profileOnce_; ProfileEnd(phase), profileOnce_ = 0)
+#define PROFILE_BEGIN(phase)    ProfileBegin(phase)
+#define PROFILE_END(phase)      ProfileEnd(phase)
+#define PROFILE_FRAME()         ProfileFrame()
+
+#else
+
+#define PROFILE_SCOPE(phase)
+#define PROFILE_BEGIN(phase)    ((void)0)
+#define PROFILE_END(phase)      ((void)0)
+#define PROFILE_FRAME()         ((void)0)
+
+#endif
+
+#endif // PROFILE_H
@@ -0,0 +1,211 @@
+#include "render.h"
+#include "raymath.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const int defaultWidths[SPRITE_COUNT]  = { 79, 50, 10, 95, 100 };
+static const int defaultHeights[SPRITE_COUNT] = { 78, 50, 10, 50, 100 };
+
+void LayoutDefaultGameplayAtlas(SpriteAtlas *atlas) {
+    PackSpriteAtlas(atlas, defaultWidths, defaultHeights, SPRITE_COUNT);
+}
+
+// Solid colours drawn while the atlas texture is still streaming in
+static const Color placeholderTints[SPRITE_COUNT] = { YELLOW, RED, WHITE, GRAY, PURPLE };
+
+static Color SpriteTint(const SpriteAtlas *atlas, int sprite) {
+    return (atlas->texture.id != 0) ? WHITE : placeholderTints[sprite];
+}
+
+// ------------ Interpolation ------------
+static void GrowSlotArrays(float **x, float **y, unsigned int **stamp, unsigned int **generation, int *capacity, int needed) {
+    if (needed <= *capacity) return;
+    *x = realloc(*x, needed * sizeof(float));
+    *y = realloc(*y, needed * sizeof(float));
+    *stamp = realloc(*stamp, needed * sizeof(unsigned int));
+    *generation = realloc(*generation, needed * sizeof(unsigned int));
+    memset(*stamp + *capacity, 0, (needed - *capacity) * sizeof(unsigned int));
+    *capacity = needed;
+}
+
+void CaptureRenderHistory(RenderHistory *history, const World *world) {
+    history->capture++;
+    if (history->capture == 0) {
+        // Wrapped: stale stamps could match again
+        memset(history->enemyStamp, 0, history->enemyCapacity * sizeof(unsigned int));
+        memset(history->bulletStamp, 0, history->bulletCapacity * sizeof(unsigned int));
+        history->capture = 1;
+    }
+
+    history->valid = true;
+    history->state = world->state;
+    history->playerPos = world->playerPos;
+    history->ballPos = world->ballPos;
+    for (int i = 0; i < NUM_PINS; i++) history->pinPos[i] = world->pins[i].position;
+
+    if (world->state != GAMEPLAY) return;
+
+    const EntityPool *enemies = &world->enemies.pool;
+    GrowSlotArrays(&history->enemyX, &history->enemyY, &history->enemyStamp, &history->enemyGeneration, &history->enemyCapacity, enemies->capacity);
+    for (int i = 0; i < enemies->count; i++) {
+        int slot = EntityDenseToSlot(enemies, i);
+        history->enemyX[slot] = ENTITY_AT(&world->enemies, x, i);
+        history->enemyY[slot] = ENTITY_AT(&world->enemies, y, i);
+        history->enemyStamp[slot] = history->capture;
+        history->enemyGeneration[slot] = POOL_GENERATION(enemies, slot);
+    }
+
+    const EntityPool *bullets = &world->bullets.pool;
+    GrowSlotArrays(&history->bulletX, &history->bulletY, &history->bulletStamp, &history->bulletGeneration, &history->bulletCapacity, bullets->capacity);
+    for (int i = 0; i < bullets->count; i++) {
+        int slot = EntityDenseToSlot(bullets, i);
+        history->bulletX[slot] = ENTITY_AT(&world->bullets, x, i);
+        history->bulletY[slot] = ENTITY_AT(&world->bullets, y, i);
+        history->bulletStamp[slot] = history->capture;
+        history->bulletGeneration[slot] = POOL_GENERATION(bullets, slot);
+    }
+}
+
+void InvalidateRenderHistory(RenderHistory *history) {
+    history->valid = false;
+}
+
+void UnloadRenderHistory(RenderHistory *history) {
+    free(history->enemyX); free(history->enemyY); free(history->enemyStamp); free(history->enemyGeneration);
+    free(history->bulletX); free(history->bulletY); free(history->bulletStamp); free(history->bulletGeneration);
+    memset(history, 0, sizeof(*history));
+}
+
+// Position of the entity in slot as captured, if that same entity was alive at the capture
+static bool CapturedAt(const float *x, const float *y, const unsigned int *stamp, const unsigned int *generation, int capacity,
+                       const RenderHistory *history, const EntityPool *pool, int slot, Vector2 *out) {
+    if (slot >= capacity || stamp[slot] != history->capture || generation[slot] != POOL_GENERATION(pool, slot)) return false;
+    *out = (Vector2){ x[slot], y[slot] };
+    return true;
+}
+
+// ------------ Snapshots ------------
+static void GrowMotions(Motion **motions, int *capacity, int needed) {
+    if (needed <= *capacity) return;
+    int grown = (*capacity > 0) ? *capacity : ENTITY_CHUNK_SIZE;
+    while (grown < needed) grown *= 2;
+    *motions = realloc(*motions, grown * sizeof(Motion));
+    *capacity = grown;
+}
+
+void BuildWorldSnapshot(WorldSnapshot *snapshot, const World *world, const RenderHistory *history) {
+    bool blend = history != NULL && history->valid && history->state == world->state;
+
+    snapshot->state = world->state;
+    snapshot->difficulty = world->difficulty;
+    snapshot->secondChanceUsed = world->secondChanceUsed;
+    snapshot->score = world->score;
+    snapshot->tick = world->tick;
+
+    snapshot->player = (Motion){ blend ? history->playerPos : world->playerPos, world->playerPos };
+    snapshot->elixirAvailable = world->elixirAvailable;
+    snapshot->elixirReady = world->elixirReady;
+    snapshot->elixirPos = world->elixirPos;
+    if (snapshot->obstacleVersion != world->obstacles.version) {
+        const ObstacleMap *rocks = &world->obstacles;
+        if (rocks->count > snapshot->obstacleCapacity) {
+            snapshot->obstacles = realloc(snapshot->obstacles, rocks->count * sizeof(Rectangle));
+            snapshot->obstacleCapacity = rocks->count;
+        }
+        if (rocks->count > 0) memcpy(snapshot->obstacles, rocks->rects, rocks->count * sizeof(Rectangle));
+        snapshot->obstacleCount = rocks->count;
+        snapshot->obstacleVersion = rocks->version;
+    }
+
+    memcpy(snapshot->pins, world->pins, sizeof(snapshot->pins));
+    for (int i = 0; i < NUM_PINS; i++) {
+        snapshot->pinMotion[i] = (Motion){ blend ? history->pinPos[i] : world->pins[i].position, world->pins[i].position };
+    }
+    snapshot->ball = (Motion){ blend ? history->ballPos : world->ballPos, world->ballPos };
+    snapshot->throwAngle = world->throwAngle;
+    snapshot->power = world->power;
+    snapshot->ballLaunched = world->ballLaunched;
+    snapshot->ballInPlay = !world->ballLaunched || world->t < PI / 2;
+    snapshot->charging = world->charging;
+    snapshot->strikeMode = world->strikeMode;
+
+    // Only GAMEPLAY draws the swarm
+    snapshot->enemyCount = 0;
+    snapshot->bulletCount = 0;
+    if (world->state != GAMEPLAY) return;
+
+    const EntityPool *enemies = &world->enemies.pool;
+    GrowMotions(&snapshot->enemies, &snapshot->enemyCapacity, enemies->count);
+    for (int i = 0; i < enemies->count; i++) {
+        Vector2 p = { ENTITY_AT(&world->enemies, x, i), ENTITY_AT(&world->enemies, y, i) }, from = p;
+        if (blend) CapturedAt(history->enemyX, history->enemyY, history->enemyStamp, history->enemyGeneration, history->enemyCapacity,
+                              history, enemies, EntityDenseToSlot(enemies, i), &from);
+        snapshot->enemies[i] = (Motion){ from, p };
+    }
+    snapshot->enemyCount = enemies->count;
+
+    const EntityPool *bullets = &world->bullets.pool;
+    GrowMotions(&snapshot->bullets, &snapshot->bulletCapacity, bullets->count);
+    for (int i = 0; i < bullets->count; i++) {
+        Vector2 p = { ENTITY_AT(&world->bullets, x, i), ENTITY_AT(&world->bullets, y, i) }, from = p;
+        if (blend) CapturedAt(history->bulletX, history->bulletY, history->bulletStamp, history->bulletGeneration, history->bulletCapacity,
+                              history, bullets, EntityDenseToSlot(bullets, i), &from);
+        snapshot->bullets[i] = (Motion){ from, p };
+    }
+    snapshot->bulletCount = bullets->count;
+}
+
+void UnloadWorldSnapshot(WorldSnapshot *snapshot) {
+    free(snapshot->enemies);
+    free(snapshot->bullets);
+    free(snapshot->obstacles);
+    memset(snapshot, 0, sizeof(*snapshot));
+}
+
+float SnapshotAlpha(const WorldSnapshot *snapshot, double now) {
+    if (snapshot->stepLength <= 0.0f) return 1.0f;
+    return Clamp((float)((now - snapshot->stepTime) / snapshot->stepLength), 0.0f, 1.0f);
+}
+
+Vector2 MotionAt(Motion motion, float alpha) {
+    return Vector2Lerp(motion.from, motion.to, alpha);
+}
+
+// ------------ Sprites ------------
+static void PushCentered(SpriteBatch *batch, const SpriteAtlas *atlas, int sprite, float x, float y, float w, float h, int layer) {
+    PushSprite(batch, atlas, sprite, (Rectangle){ x - w/2.0f, y - h/2.0f, w, h }, SpriteTint(atlas, sprite), layer);
+}
+
+void PushGameplaySprites(SpriteBatch *batch, const SpriteAtlas *atlas, const WorldSnapshot *snapshot, float alpha) {
+    if (atlas->present[SPRITE_PLAYER]) {
+        Rectangle r = atlas->rects[SPRITE_PLAYER];
+        Vector2 p = MotionAt(snapshot->player, alpha);
+        PushCentered(batch, atlas, SPRITE_PLAYER, p.x, p.y, r.width, r.height, LAYER_PLAYER);
+    }
+
+    if (atlas->present[SPRITE_BULLET]) {
+        for (int i = 0; i < snapshot->bulletCount; i++) {
+            Vector2 p = MotionAt(snapshot->bullets[i], alpha);
+            PushCentered(batch, atlas, SPRITE_BULLET, p.x, p.y, 10.0f, 10.0f, LAYER_BULLETS);
+        }
+    }
+
+    if (atlas->present[SPRITE_ENEMY]) {
+        Rectangle r = atlas->rects[SPRITE_ENEMY];
+        for (int i = 0; i < snapshot->enemyCount; i++) {
+            Vector2 p = MotionAt(snapshot->enemies[i], alpha);
+            PushCentered(batch, atlas, SPRITE_ENEMY, p.x, p.y, r.width, r.height, LAYER_ENEMIES);
+        }
+    }
+
+    // Elixir is always drawn at 100x100; the caller draws a fallback when the sprite is missing
+    if (snapshot->elixirAvailable && atlas->present[SPRITE_ELIXIR]) {
+        PushCentered(batch, atlas, SPRITE_ELIXIR, snapshot->elixirPos.x, snapshot->elixirPos.y, 100.0f, 100.0f, LAYER_ELIXIR);
+    }
+
+    if (atlas->present[SPRITE_OBSTACLE]) {
+        for (int i = 0; i < snapshot->obstacleCount; i++) {
+            PushSprite(batch, atlas, SPRITE_OBSTACLE, snapshot->obstacles[i], SpriteTint(atlas, SPRITE_OBSTACLE), LAYER_OBSTACLES);
+        }
+    }
+}
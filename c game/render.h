@@ -0,0 +1,108 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "world.h"
+#include "batch.h"
+
+// Sprites packed into the gameplay atlas
+typedef enum {
+    SPRITE_PLAYER,
+    SPRITE_ENEMY,
+    SPRITE_BULLET,
+    SPRITE_OBSTACLE,
+    SPRITE_ELIXIR,
+    SPRITE_COUNT
+} SpriteId;
+
+// Back to front, matching the order the scene has always been drawn in
+typedef enum {
+    LAYER_PLAYER,
+    LAYER_BULLETS,
+    LAYER_ENEMIES,
+    LAYER_ELIXIR,
+    LAYER_OBSTACLES
+} SpriteLayer;
+
+// Positions as of the step before the latest one, kept by whoever steps the world so each
+// snapshot can carry both ends of its step. Entities are keyed by pool slot and generation:
+// anything spawned since has no earlier position and is drawn where it is.
+typedef struct {
+    bool       valid;
+    GameState  state;          // A scene change in between disables blending for that step
+    unsigned int capture;      // Bumped per capture; slot stamps equal to it were alive then
+    Vector2    playerPos;
+    Vector2    ballPos;
+    Vector2    pinPos[NUM_PINS];
+
+    // Per pool slot, grown to match the pools
+    float        *enemyX, *enemyY, *bulletX, *bulletY;
+    unsigned int *enemyStamp, *bulletStamp, *enemyGeneration, *bulletGeneration;
+    int enemyCapacity, bulletCapacity;
+} RenderHistory;
+
+// Call right before each StepWorld(); Invalidate after jumps the renderer should not blend over
+void CaptureRenderHistory(RenderHistory *history, const World *world);
+void InvalidateRenderHistory(RenderHistory *history);
+void UnloadRenderHistory(RenderHistory *history);
+
+// Where something was one step before the snapshot and where it is now
+typedef struct {
+    Vector2 from;
+    Vector2 to;
+} Motion;
+
+// Everything the renderer reads, copied out of the world after a step. The world steps at a
+// fixed rate and drawing blends each motion by how far the display is into the next step.
+typedef struct {
+    GameState  state;
+    Difficulty difficulty;
+    bool       secondChanceUsed;
+    int        score;
+    unsigned long long tick;
+
+    Motion     player;
+    bool       elixirAvailable;
+    bool       elixirReady;
+    Vector2    elixirPos;
+    Rectangle *obstacles;      // Copied only when the map's version moves; grown, never shrunk
+    int        obstacleCount;
+    int        obstacleCapacity;
+    unsigned int obstacleVersion;
+
+    Pin        pins[NUM_PINS];
+    Motion     pinMotion[NUM_PINS];
+    Motion     ball;
+    float      throwAngle;
+    float      power;
+    bool       ballLaunched;
+    bool       ballInPlay;     // Launched and still on the lane, or waiting to be
+    bool       charging;
+    bool       strikeMode;
+    unsigned int pinHits;      // Running count, so a hit shows up even in a snapshot nobody drew
+
+    Motion    *enemies;        // Dense order; grown, never shrunk
+    Motion    *bullets;
+    int        enemyCount, enemyCapacity;
+    int        bulletCount, bulletCapacity;
+
+    double     stepTime;       // NowSeconds() when the step finished
+    float      stepLength;     // Its dt
+} WorldSnapshot;
+
+// Copies the world into snapshot; history (may be NULL) supplies the motions' start points
+void BuildWorldSnapshot(WorldSnapshot *snapshot, const World *world, const RenderHistory *history);
+void UnloadWorldSnapshot(WorldSnapshot *snapshot);
+
+// How far into the step after the snapshot now is: 0 draws the previous step, 1 the latest
+float SnapshotAlpha(const WorldSnapshot *snapshot, double now);
+Vector2 MotionAt(Motion motion, float alpha);
+
+// Atlas layout for the stock sprite sizes, for headless tools that never load images
+void LayoutDefaultGameplayAtlas(SpriteAtlas *atlas);
+
+// Pushes every GAMEPLAY sprite of the snapshot into an already begun batch, each motion
+// blended by alpha. With no atlas texture yet (LayoutDefaultGameplayAtlas() while streaming)
+// sprites get placeholder colours.
+void PushGameplaySprites(SpriteBatch *batch, const SpriteAtlas *atlas, const WorldSnapshot *snapshot, float alpha);
+
+#endif // RENDER_H
@@ -0,0 +1,209 @@
+#include "replay.h"
+#include <string.h>
+
+// Record tags. A step is 0x80 | held buttons, with REPLAY_STEP_EDGES set when a pressed and a
+// released byte follow; everything else is a small tag and a fixed payload.
+enum {
+    REPLAY_TAG_START_RUN    = 0x01,    // u8 difficulty
+    REPLAY_TAG_RETURN_MENU  = 0x02,
+    REPLAY_TAG_VIEW         = 0x03,    // 6 floats: width, height, playerSize, obstacleSize
+    REPLAY_TAG_DT           = 0x04,    // float, applies to every following step
+    REPLAY_TAG_CHECK        = 0x05,    // u64 tick, u64 HashWorld()
+    REPLAY_TAG_STEP         = 0x80
+};
+
+#define REPLAY_STEP_EDGES    0x40
+#define REPLAY_BUTTON_MASK   0x3F
+
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int seed;
+    unsigned int hashInterval;
+} ReplayHeader;
+
+// ------------ Recording ------------
+static void Write(ReplayRecorder *recorder, const void *data, size_t size) {
+    if (recorder->file == NULL) return;
+    fwrite(data, 1, size, recorder->file);
+    recorder->bytes += size;
+}
+
+static void WriteTag(ReplayRecorder *recorder, unsigned char tag) {
+    Write(recorder, &tag, 1);
+}
+
+// The shell may resize the playfield or swap sprite sizes between calls, and StartRun() uses them too
+static void WriteView(ReplayRecorder *recorder, const World *world) {
+    float view[6] = { world->width, world->height, world->playerSize.x, world->playerSize.y,
+                      world->obstacleSize.x, world->obstacleSize.y };
+    if (recorder->viewWritten && memcmp(view, recorder->view, sizeof(view)) == 0) return;
+
+    WriteTag(recorder, REPLAY_TAG_VIEW);
+    Write(recorder, view, sizeof(view));
+    memcpy(recorder->view, view, sizeof(view));
+    recorder->viewWritten = true;
+}
+
+bool BeginRecording(ReplayRecorder *recorder, World *world, const char *fileName, unsigned int seed) {
+    memset(recorder, 0, sizeof(*recorder));
+    recorder->hashInterval = REPLAY_HASH_INTERVAL;
+    SeedWorld(world, seed);
+
+    if (fileName == NULL) return true;
+    recorder->file = fopen(fileName, "wb");
+    if (recorder->file == NULL) {
+        TraceLog(LOG_WARNING, "REPLAY: Could not open %s for recording", fileName);
+        return false;
+    }
+
+    ReplayHeader header = { REPLAY_MAGIC, REPLAY_VERSION, seed, (unsigned int)recorder->hashInterval };
+    Write(recorder, &header, sizeof(header));
+    return true;
+}
+
+void EndRecording(ReplayRecorder *recorder) {
+    if (recorder->file != NULL) {
+        fclose(recorder->file);
+        TraceLog(LOG_INFO, "REPLAY: Recorded %llu steps in %zu bytes", recorder->steps, recorder->bytes);
+    }
+    memset(recorder, 0, sizeof(*recorder));
+}
+
+void RecordedStartRun(ReplayRecorder *recorder, World *world, Difficulty difficulty) {
+    WriteView(recorder, world);
+    WriteTag(recorder, REPLAY_TAG_START_RUN);
+    unsigned char d = (unsigned char)difficulty;
+    Write(recorder, &d, 1);
+    StartRun(world, difficulty);
+}
+
+void RecordedReturnToMenu(ReplayRecorder *recorder, World *world) {
+    WriteTag(recorder, REPLAY_TAG_RETURN_MENU);
+    ReturnToMenu(world);
+}
+
+void RecordedStep(ReplayRecorder *recorder, World *world, WorldInputs inputs, float dt) {
+    if (recorder->file != NULL) {
+        WriteView(recorder, world);
+
+        if (recorder->steps == 0 || dt != recorder->lastDt) {
+            WriteTag(recorder, REPLAY_TAG_DT);
+            Write(recorder, &dt, sizeof(dt));
+            recorder->lastDt = dt;
+        }
+
+        unsigned char step = REPLAY_TAG_STEP | (inputs.down & REPLAY_BUTTON_MASK);
+        if (inputs.pressed != 0 || inputs.released != 0) {
+            unsigned char edges[2] = { inputs.pressed & REPLAY_BUTTON_MASK, inputs.released & REPLAY_BUTTON_MASK };
+            step |= REPLAY_STEP_EDGES;
+            WriteTag(recorder, step);
+            Write(recorder, edges, sizeof(edges));
+        } else {
+            WriteTag(recorder, step);
+        }
+    }
+
+    StepWorld(world, inputs, dt);
+    recorder->steps++;
+
+    if (recorder->file != NULL && recorder->steps % recorder->hashInterval == 0) {
+        unsigned long long check[2] = { world->tick, HashWorld(world) };
+        WriteTag(recorder, REPLAY_TAG_CHECK);
+        Write(recorder, check, sizeof(check));
+    }
+}
+
+// ------------ Playback ------------
+static bool Read(ReplayPlayer *player, void *out, size_t size) {
+    if (player->pos + size > player->file.size) {
+        player->corrupt = true;
+        return false;
+    }
+    memcpy(out, player->file.data + player->pos, size);
+    player->pos += size;
+    return true;
+}
+
+bool OpenReplay(ReplayPlayer *player, World *world, const char *fileName) {
+    memset(player, 0, sizeof(*player));
+    if (!MapFile(&player->file, fileName)) return false;
+
+    ReplayHeader header;
+    if (!Read(player, &header, sizeof(header)) || header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION) {
+        TraceLog(LOG_WARNING, "REPLAY: %s is not a version %d replay", fileName, REPLAY_VERSION);
+        UnmapFile(&player->file);
+        return false;
+    }
+
+    player->seed = header.seed;
+    player->hashInterval = (int)header.hashInterval;
+    SeedWorld(world, player->seed);
+    return true;
+}
+
+void CloseReplay(ReplayPlayer *player) {
+    UnmapFile(&player->file);
+    memset(player, 0, sizeof(*player));
+}
+
+static void CheckHash(ReplayPlayer *player, const World *world) {
+    unsigned long long check[2];
+    if (!Read(player, check, sizeof(check))) return;
+
+    player->checks++;
+    if (check[0] != world->tick || check[1] != HashWorld(world)) {
+        if (player->mismatches == 0) {
+            player->firstMismatch = world->tick;
+            TraceLog(LOG_WARNING, "REPLAY: Desync at tick %llu (recorded tick %llu)", world->tick, check[0]);
+        }
+        player->mismatches++;
+    }
+}
+
+bool PlayReplayStep(ReplayPlayer *player, World *world) {
+    while (!player->corrupt && player->pos < player->file.size) {
+        unsigned char tag = player->file.data[player->pos++];
+
+        if (tag & REPLAY_TAG_STEP) {
+            WorldInputs inputs = { 0 };
+            inputs.down = tag & REPLAY_BUTTON_MASK;
+            if (tag & REPLAY_STEP_EDGES) {
+                unsigned char edges[2];
+                if (!Read(player, edges, sizeof(edges))) return false;
+                inputs.pressed = edges[0];
+                inputs.released = edges[1];
+            }
+
+            StepWorld(world, inputs, player->dt);
+            player->steps++;
+
+            // A hash, when there is one, directly follows the step it was taken after
+            if (player->pos < player->file.size && player->file.data[player->pos] == REPLAY_TAG_CHECK) {
+                player->pos++;
+                CheckHash(player, world);
+            }
+            return true;
+        }
+
+        switch (tag) {
+            case REPLAY_TAG_START_RUN: {
+                unsigned char difficulty;
+                if (Read(player, &difficulty, 1)) StartRun(world, (Difficulty)difficulty);
+            } break;
+            case REPLAY_TAG_RETURN_MENU: ReturnToMenu(world); break;
+            case REPLAY_TAG_VIEW: {
+                float view[6];
+                if (!Read(player, view, sizeof(view))) break;
+                world->width = view[0];
+                world->height = view[1];
+                world->playerSize = (Vector2){ view[2], view[3] };
+                world->obstacleSize = (Vector2){ view[4], view[5] };
+            } break;
+            case REPLAY_TAG_DT: Read(player, &player->dt, sizeof(player->dt)); break;
+            case REPLAY_TAG_CHECK: CheckHash(player, world); break;
+            default: player->corrupt = true; break;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,60 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "world.h"
+#include "mapfile.h"
+#include <stdio.h>
+#include <stdbool.h>
+
+#define REPLAY_MAGIC          0x50524743u    // "CGRP" little-endian
+#define REPLAY_VERSION        11             // 2: bowling and pins scale with dt, 3: Hard enemies follow the flow field, 4: Poisson-disk rocks,
+                                             // 5: bullets carry a lifetime and leave through every edge, 6: pin physics,
+                                             // 7: swept collisions, 8: the world draws from its own generator and a strike resumes the run,
+                                             // 9: a random stream per system, seeded through the world, 10: a resumed run steps clear of the rocks,
+                                             // 11: stream ids mixed in after the seed
+#define REPLAY_HASH_INTERVAL  60             // Ticks between state hashes in new recordings
+
+// Everything that drives the simulation goes through these, so a session can be written out
+// and fed back tick for tick. The stream is a header (seed, hash interval) followed by tagged
+// records; a plain step is one byte, plus four more only when dt changed since the last step.
+typedef struct {
+    FILE *file;               // NULL when not recording; the wrappers still drive the world
+    int   hashInterval;
+    float lastDt;
+    float view[6];            // width, height, playerSize, obstacleSize last written
+    bool  viewWritten;
+    unsigned long long steps;
+    size_t bytes;
+} ReplayRecorder;
+
+// Seeds the freshly initialised world with seed and starts writing; with fileName NULL only
+// the seed is applied
+bool BeginRecording(ReplayRecorder *recorder, World *world, const char *fileName, unsigned int seed);
+void EndRecording(ReplayRecorder *recorder);
+
+void RecordedStartRun(ReplayRecorder *recorder, World *world, Difficulty difficulty);
+void RecordedReturnToMenu(ReplayRecorder *recorder, World *world);
+void RecordedStep(ReplayRecorder *recorder, World *world, WorldInputs inputs, float dt);
+
+typedef struct {
+    MappedFile file;
+    size_t pos;
+    unsigned int seed;
+    int   hashInterval;
+    float dt;
+    unsigned long long steps;
+    unsigned long long checks;           // Hashes compared so far
+    unsigned long long mismatches;
+    unsigned long long firstMismatch;    // Tick of the first mismatch, valid when mismatches > 0
+    bool  corrupt;                       // Stream ended mid-record or held an unknown tag
+} ReplayPlayer;
+
+// Maps the file and seeds the freshly initialised world the way the recording started
+bool OpenReplay(ReplayPlayer *player, World *world, const char *fileName);
+void CloseReplay(ReplayPlayer *player);
+
+// Applies records up to and including the next step, checking any hash that follows it.
+// The world must be freshly initialised before the first call. False at the end of the stream.
+bool PlayReplayStep(ReplayPlayer *player, World *world);
+
+#endif // REPLAY_H
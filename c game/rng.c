@@ -0,0 +1,180 @@
+#include "rng.h"
+#include <stdbool.h>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+    #define RNG_X86 1
+    #include <immintrin.h>
+#endif
+
+#define RANDOM_UNIT  (1.0f / 16777216.0f)   // Top 24 bits of a draw scaled into [0, 1)
+
+// Two rounds of a 32-bit integer hash (Wellons' lowbias32 and its sibling) with a key folded
+// in before each; a bijection of n for any key
+static unsigned int Hash(const unsigned int key[2], unsigned int n) {
+    unsigned int x = n ^ key[0];
+    x = (x ^ (x >> 16)) * 0x21F0AAADu;
+    x = (x ^ (x >> 15)) * 0x735A2D97u;
+    x = (x ^ (x >> 15)) ^ key[1];
+    x = (x ^ (x >> 16)) * 0x7FEB352Du;
+    x = (x ^ (x >> 15)) * 0x846CA68Bu;
+    return x ^ (x >> 16);
+}
+
+static unsigned long long SplitMix64(unsigned long long *state) {
+    unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// The seed is scrambled before the id goes in, so no shift or flip of the seed stands in for
+// another id
+void SeedRandomStream(RandomStream *stream, unsigned long long seed, unsigned int id) {
+    unsigned long long seedState = seed;
+    unsigned long long state = SplitMix64(&seedState) ^ id;
+    unsigned long long key = SplitMix64(&state);
+    key = SplitMix64(&state) ^ (key << 1);
+    stream->key[0] = (unsigned int)key;
+    stream->key[1] = (unsigned int)(key >> 32);
+    stream->counter = 0;
+}
+
+// min + bits scaled into the range's width, without a divide
+static int ScaleInt(unsigned int bits, int min, unsigned int width) {
+    if (width == 0) return (int)((unsigned int)min + bits);   // The full 32-bit range
+    return (int)((unsigned int)min + (unsigned int)(((unsigned long long)bits * width) >> 32));
+}
+
+static float ScaleFloat(unsigned int bits, float min, float max) {
+    return min + (max - min) * ((float)(bits >> 8) * RANDOM_UNIT);
+}
+
+unsigned int NextRandom(RandomStream *stream) {
+    return Hash(stream->key, stream->counter++);
+}
+
+int RandomInt(RandomStream *stream, int min, int max) {
+    return ScaleInt(NextRandom(stream), min, (unsigned int)max - (unsigned int)min + 1u);
+}
+
+float RandomFloat(RandomStream *stream, float min, float max) {
+    return ScaleFloat(NextRandom(stream), min, max);
+}
+
+// ------------ Bulk fills ------------
+void FillRandomScalar(RandomStream *stream, unsigned int *out, int count) {
+    for (int i = 0; i < count; i++) out[i] = NextRandom(stream);
+}
+
+void FillRandomIntsScalar(RandomStream *stream, int *out, int count, int min, int max) {
+    for (int i = 0; i < count; i++) out[i] = RandomInt(stream, min, max);
+}
+
+void FillRandomFloatsScalar(RandomStream *stream, float *out, int count, float min, float max) {
+    for (int i = 0; i < count; i++) out[i] = RandomFloat(stream, min, max);
+}
+
+#if defined(RNG_X86)
+// Hash() of the eight counts n..n+7
+__attribute__((target("avx2")))
+static inline __m256i HashAVX2(const unsigned int key[2], unsigned int n) {
+    __m256i x = _mm256_add_epi32(_mm256_set1_epi32((int)n), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    x = _mm256_xor_si256(x, _mm256_set1_epi32((int)key[0]));
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 16)), _mm256_set1_epi32((int)0x21F0AAADu));
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 15)), _mm256_set1_epi32((int)0x735A2D97u));
+    x = _mm256_xor_si256(_mm256_xor_si256(x, _mm256_srli_epi32(x, 15)), _mm256_set1_epi32((int)key[1]));
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 16)), _mm256_set1_epi32((int)0x7FEB352Du));
+    x = _mm256_mullo_epi32(_mm256_xor_si256(x, _mm256_srli_epi32(x, 15)), _mm256_set1_epi32((int)0x846CA68Bu));
+    return _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+}
+
+__attribute__((target("avx2")))
+static void FillAVX2(RandomStream *stream, unsigned int *out, int count) {
+    int i = 0;
+    for (; i + 8 <= count; i += 8, stream->counter += 8) {
+        _mm256_storeu_si256((__m256i *)(out + i), HashAVX2(stream->key, stream->counter));
+    }
+    FillRandomScalar(stream, out + i, count - i);
+}
+
+// The high half of each 32x32-bit product, as ScaleInt() takes it
+__attribute__((target("avx2")))
+static void FillIntsAVX2(RandomStream *stream, int *out, int count, int min, int max) {
+    unsigned int width = (unsigned int)max - (unsigned int)min + 1u;
+    if (width == 0) {
+        FillRandomIntsScalar(stream, out, count, min, max);
+        return;
+    }
+    const __m256i vwidth = _mm256_set1_epi32((int)width), vmin = _mm256_set1_epi32(min);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8, stream->counter += 8) {
+        __m256i bits = HashAVX2(stream->key, stream->counter);
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(bits, vwidth), 32);
+        __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(bits, 32), vwidth);
+        __m256i scaled = _mm256_blend_epi32(even, odd, 0xAA);
+        _mm256_storeu_si256((__m256i *)(out + i), _mm256_add_epi32(scaled, vmin));
+    }
+    FillRandomIntsScalar(stream, out + i, count - i, min, max);
+}
+
+// Same operations in the same order as ScaleFloat(), no FMA, so the results are bit-identical
+__attribute__((target("avx2")))
+static void FillFloatsAVX2(RandomStream *stream, float *out, int count, float min, float max) {
+    const __m256 vmin = _mm256_set1_ps(min), span = _mm256_set1_ps(max - min), unit = _mm256_set1_ps(RANDOM_UNIT);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8, stream->counter += 8) {
+        __m256 u = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(HashAVX2(stream->key, stream->counter), 8)), unit);
+        _mm256_storeu_ps(out + i, _mm256_add_ps(vmin, _mm256_mul_ps(span, u)));
+    }
+    FillRandomFloatsScalar(stream, out + i, count - i, min, max);
+}
+
+static bool HasAVX2(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached == 1;
+}
+#endif
+
+void FillRandom(RandomStream *stream, unsigned int *out, int count) {
+#if defined(RNG_X86)
+    if (HasAVX2()) {
+        FillAVX2(stream, out, count);
+        return;
+    }
+#endif
+    FillRandomScalar(stream, out, count);
+}
+
+void FillRandomInts(RandomStream *stream, int *out, int count, int min, int max) {
+#if defined(RNG_X86)
+    if (HasAVX2()) {
+        FillIntsAVX2(stream, out, count, min, max);
+        return;
+    }
+#endif
+    FillRandomIntsScalar(stream, out, count, min, max);
+}
+
+void FillRandomFloats(RandomStream *stream, float *out, int count, float min, float max) {
+#if defined(RNG_X86)
+    if (HasAVX2()) {
+        FillFloatsAVX2(stream, out, count, min, max);
+        return;
+    }
+#endif
+    FillRandomFloatsScalar(stream, out, count, min, max);
+}
+
+const char *FillRandomPath(void) {
+#if defined(RNG_X86)
+    return HasAVX2() ? "avx2" : "scalar";
+#else
+    return "scalar";
+#endif
+}
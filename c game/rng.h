@@ -0,0 +1,33 @@
+#ifndef RNG_H
+#define RNG_H
+
+// Counter-based random streams. Draw n of a stream is a keyed hash of n, so a stream is only
+// a key and a count, any draw can be made without the ones before it, and streams with
+// different keys are independent of each other and of the order they are drawn from. The bulk
+// fills hash eight counts at once with AVX2 where the CPU has it and return exactly what as
+// many single draws would.
+typedef struct {
+    unsigned int key[2];
+    unsigned int counter;     // Draws taken; a stream repeats after 2^32
+} RandomStream;
+
+// Stream id of a seed; different ids of one seed are independent streams
+void SeedRandomStream(RandomStream *stream, unsigned long long seed, unsigned int id);
+
+unsigned int NextRandom(RandomStream *stream);
+int   RandomInt(RandomStream *stream, int min, int max);            // min to max inclusive, like GetRandomValue()
+float RandomFloat(RandomStream *stream, float min, float max);      // [min, max)
+
+void FillRandom(RandomStream *stream, unsigned int *out, int count);
+void FillRandomInts(RandomStream *stream, int *out, int count, int min, int max);
+void FillRandomFloats(RandomStream *stream, float *out, int count, float min, float max);
+
+// The same fills one draw at a time, to check the vector path against
+void FillRandomScalar(RandomStream *stream, unsigned int *out, int count);
+void FillRandomIntsScalar(RandomStream *stream, int *out, int count, int min, int max);
+void FillRandomFloatsScalar(RandomStream *stream, float *out, int count, float min, float max);
+
+// Name of the path the fills use on this machine: "avx2" or "scalar"
+const char *FillRandomPath(void);
+
+#endif // RNG_H
@@ -0,0 +1,63 @@
+#include "rollback.h"
+#include <string.h>
+
+void InitRollback(RollbackSession *session) {
+    memset(session, 0, sizeof(*session));
+}
+
+void UnloadRollback(RollbackSession *session) {
+    for (int i = 0; i < ROLLBACK_WINDOW; i++) UnloadWorldCheckpoint(&session->saves[i]);
+    memset(session, 0, sizeof(*session));
+}
+
+static WorldInputs PredictInputs(const RollbackSession *session) {
+    return (WorldInputs){ session->confirmedDown, 0, 0 };
+}
+
+static bool SameInputs(WorldInputs a, WorldInputs b) {
+    return a.down == b.down && a.pressed == b.pressed && a.released == b.released;
+}
+
+// Saves and steps tick (stepped), keeping its checkpoint unless the caller restored it already
+static void StepTick(RollbackSession *session, World *world, bool save) {
+    int slot = (int)(session->stepped % ROLLBACK_WINDOW);
+    if (save) SaveWorldCheckpoint(world, &session->saves[slot]);
+    StepWorld(world, session->inputs[slot], session->dts[slot]);
+    session->stepped++;
+}
+
+bool RollbackStep(RollbackSession *session, World *world, float dt) {
+    if (session->stepped - session->confirmed >= ROLLBACK_WINDOW) return false;
+    int slot = (int)(session->stepped % ROLLBACK_WINDOW);
+    session->inputs[slot] = PredictInputs(session);
+    session->dts[slot] = dt;
+    StepTick(session, world, true);
+    return true;
+}
+
+bool ConfirmInputs(RollbackSession *session, World *world, WorldInputs inputs) {
+    if (session->confirmed == session->stepped) return false;
+    unsigned long long tick = session->confirmed;
+    int slot = (int)(tick % ROLLBACK_WINDOW);
+
+    // A miss goes back to the tick as it began, then forward again with the real input and
+    // fresh predictions for every tick after it; nothing is confirmed if it cannot go back
+    bool predicted = SameInputs(session->inputs[slot], inputs);
+    if (!predicted && !RestoreWorldCheckpoint(world, &session->saves[slot])) return false;
+    session->confirmed++;
+    session->confirmedDown = inputs.down;
+    if (predicted) return true;
+
+    unsigned long long present = session->stepped;
+    session->inputs[slot] = inputs;
+    session->stepped = tick;
+    StepTick(session, world, false);
+    while (session->stepped < present) {
+        session->inputs[session->stepped % ROLLBACK_WINDOW] = PredictInputs(session);
+        StepTick(session, world, true);
+    }
+
+    session->rollbacks++;
+    session->resimulated += (long long)(present - tick);
+    return true;
+}
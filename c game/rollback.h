@@ -0,0 +1,34 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include "world.h"
+#include <stdbool.h>
+
+#define ROLLBACK_WINDOW  16       // Ticks that may run ahead of the last confirmed input
+
+// Steps a world ahead of its inputs. Each tick is saved as it begins and stepped with a
+// prediction (the last confirmed buttons still held, no edges); when the real input for a
+// tick arrives and differs, the world goes back to that tick's checkpoint and steps forward
+// again to where it was. The ring holds the last ROLLBACK_WINDOW ticks.
+typedef struct {
+    WorldCheckpoint saves[ROLLBACK_WINDOW];   // The world as each tick in flight began
+    WorldInputs     inputs[ROLLBACK_WINDOW];  // What it was stepped with, predicted or confirmed
+    float           dts[ROLLBACK_WINDOW];
+    unsigned long long stepped;               // Ticks stepped since InitRollback()
+    unsigned long long confirmed;             // Ticks whose input is known
+    unsigned int    confirmedDown;            // Buttons held in the last confirmed input
+    long long       rollbacks;                // Confirmations that differed from the prediction
+    long long       resimulated;              // Ticks stepped again because of them
+} RollbackSession;
+
+void InitRollback(RollbackSession *session);
+void UnloadRollback(RollbackSession *session);
+
+// Saves the world and steps one predicted tick; false, without stepping, when the window is full
+bool RollbackStep(RollbackSession *session, World *world, float dt);
+
+// The real input for the oldest unconfirmed tick. False when no tick is waiting for one, or
+// when its checkpoint cannot be restored; the session and world are left as they were then.
+bool ConfirmInputs(RollbackSession *session, World *world, WorldInputs inputs);
+
+#endif // ROLLBACK_H
@@ -0,0 +1,75 @@
+#include "scene.h"
+#include <string.h>
+
+static const AssetId openingAssets[]  = { ASSET_LOGO, ASSET_FONT };
+static const AssetId gameplayAssets[] = { ASSET_PLAYER, ASSET_ENEMY, ASSET_ROCK, ASSET_ELIXIR, ASSET_FONT };
+static const AssetId miniGameAssets[] = { ASSET_BOWLING_BG, ASSET_HIT_SOUND };
+static const AssetId closingAssets[]  = { ASSET_BALH, ASSET_FONT };
+
+#define SCENE_ASSETS(list) { list, (int)(sizeof(list)/sizeof(list[0])) }
+
+const SceneAssets sceneAssets[SCENE_COUNT] = {
+    [OPENING_SCENE] = SCENE_ASSETS(openingAssets),
+    [GAMEPLAY]      = SCENE_ASSETS(gameplayAssets),
+    [MINI_GAME]     = SCENE_ASSETS(miniGameAssets),
+    [CLOSING_SCENE] = SCENE_ASSETS(closingAssets),
+};
+
+const char *sceneNames[SCENE_COUNT] = {
+    [OPENING_SCENE] = "OPENING_SCENE",
+    [GAMEPLAY]      = "GAMEPLAY",
+    [MINI_GAME]     = "MINI_GAME",
+    [CLOSING_SCENE] = "CLOSING_SCENE",
+};
+
+void InitSceneManager(SceneManager *scenes, AssetStreamer *streamer, size_t cacheBudget) {
+    memset(scenes, 0, sizeof(*scenes));
+    scenes->streamer = streamer;
+    scenes->cacheBudget = cacheBudget;
+}
+
+void EnterScene(SceneManager *scenes, GameState scene, const GameState *upcoming, int upcomingCount) {
+    bool hold[SCENE_COUNT] = { false };
+    hold[scene] = true;
+    for (int i = 0; i < upcomingCount; i++) hold[upcoming[i]] = true;
+
+    // Acquire before releasing so assets shared by both sides never drop to zero references
+    PrioritizeAssets(scenes->streamer, sceneAssets[scene].ids, sceneAssets[scene].count);
+    for (int s = 0; s < SCENE_COUNT; s++) {
+        if (hold[s] && !scenes->held[s]) AcquireAssets(scenes->streamer, sceneAssets[s].ids, sceneAssets[s].count);
+    }
+    for (int s = 0; s < SCENE_COUNT; s++) {
+        if (!hold[s] && scenes->held[s]) ReleaseAssets(scenes->streamer, sceneAssets[s].ids, sceneAssets[s].count);
+        scenes->held[s] = hold[s];
+    }
+
+    TrimAssetCache(scenes->streamer, scenes->cacheBudget);
+
+    scenes->scene = scene;
+    scenes->entered = true;
+
+    AssetMemory memory = GetAssetMemory(scenes->streamer, NULL, 0);
+    TraceLog(LOG_INFO, "SCENE: Entered %s, %.1f KB textures, %.1f KB audio, %.1f KB images resident (%.1f KB cached)",
+             sceneNames[scene], memory.textureBytes / 1024.0, memory.audioBytes / 1024.0,
+             memory.imageBytes / 1024.0, memory.cachedBytes / 1024.0);
+}
+
+void UpdateSceneManager(SceneManager *scenes) {
+    if (!scenes->entered) return;
+
+    AssetMemory memory = GetAssetMemory(scenes->streamer, NULL, 0);
+    AssetMemory *peak = &scenes->peak[scenes->scene];
+    if (memory.textureBytes > peak->textureBytes) peak->textureBytes = memory.textureBytes;
+    if (memory.audioBytes > peak->audioBytes) peak->audioBytes = memory.audioBytes;
+    if (memory.imageBytes > peak->imageBytes) peak->imageBytes = memory.imageBytes;
+    if (memory.cachedBytes > peak->cachedBytes) peak->cachedBytes = memory.cachedBytes;
+}
+
+void LogSceneMemory(const SceneManager *scenes) {
+    for (int s = 0; s < SCENE_COUNT; s++) {
+        const AssetMemory *peak = &scenes->peak[s];
+        TraceLog(LOG_INFO, "SCENE: %-13s peak %8.1f KB textures, %7.1f KB audio, %7.1f KB images (%.1f KB cached)",
+                 sceneNames[s], peak->textureBytes / 1024.0, peak->audioBytes / 1024.0,
+                 peak->imageBytes / 1024.0, peak->cachedBytes / 1024.0);
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "world.h"
+#include "stream.h"
+
+#define SCENE_COUNT         4
+#define ASSET_CACHE_BUDGET  (1024*1024)   // Bytes of unreferenced assets kept resident across scene flips
+
+// What a scene draws or plays
+typedef struct {
+    const AssetId *ids;
+    int count;
+} SceneAssets;
+
+extern const SceneAssets sceneAssets[SCENE_COUNT];
+extern const char *sceneNames[SCENE_COUNT];
+
+// Holds asset references for the scene on screen plus the scenes it can lead to, so those
+// stream in ahead of time. Leaving a scene drops its references; its assets then sit in the
+// LRU cache until the budget pushes them out.
+typedef struct {
+    AssetStreamer *streamer;
+    size_t     cacheBudget;
+    GameState  scene;
+    bool       entered;
+    bool       held[SCENE_COUNT];          // Scenes whose assets are currently referenced
+    AssetMemory peak[SCENE_COUNT];         // Most resident while each scene was on screen
+} SceneManager;
+
+void InitSceneManager(SceneManager *scenes, AssetStreamer *streamer, size_t cacheBudget);
+
+// Switches references to scene and upcoming, puts scene's assets first in the queue and trims the cache
+void EnterScene(SceneManager *scenes, GameState scene, const GameState *upcoming, int upcomingCount);
+
+// Once per frame after PumpAssetStreamer(), to track each scene's peak
+void UpdateSceneManager(SceneManager *scenes);
+void LogSceneMemory(const SceneManager *scenes);
+
+#endif // SCENE_H
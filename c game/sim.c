@@ -0,0 +1,168 @@
+#include "sim.h"
+#include "timing.h"
+#include <math.h>
+#include <string.h>
+
+// ------------ Commands ------------
+bool SendSimCommand(Simulation *sim, SimCommand command) {
+    SimQueue *queue = &sim->commands;
+    unsigned int tail = queue->tail;
+    if (tail - __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE) == SIM_QUEUE_SIZE) return false;
+
+    queue->items[tail & (SIM_QUEUE_SIZE - 1)] = command;
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool ReceiveSimCommand(SimQueue *queue, SimCommand *command) {
+    unsigned int head = queue->head;
+    if (head == __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE)) return false;
+
+    *command = queue->items[head & (SIM_QUEUE_SIZE - 1)];
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// Returns whether the command changed something the renderer shows
+static bool ApplyCommand(Simulation *sim, const SimCommand *command) {
+    World *world = &sim->world;
+    switch (command->type) {
+        case SIM_INPUT: {
+            sim->pendingInputs.down = command->inputs.down;
+            sim->pendingInputs.pressed |= command->inputs.pressed;
+            sim->pendingInputs.released |= command->inputs.released;
+        } return false;
+        case SIM_START_RUN: RecordedStartRun(&sim->recorder, world, command->difficulty); return true;
+        case SIM_RETURN_MENU: RecordedReturnToMenu(&sim->recorder, world); return true;
+        case SIM_VIEW: {
+            world->width = command->size.x;
+            world->height = command->size.y;
+            world->playerSize = command->playerSize;
+            world->obstacleSize = command->obstacleSize;
+        } return false;
+    }
+    return false;
+}
+
+// ------------ Snapshots ------------
+static void PublishSnapshot(Simulation *sim, double now) {
+    SnapshotBuffer *buffer = &sim->snapshots;
+    WorldSnapshot *snapshot = &buffer->buffers[buffer->back];
+    BuildWorldSnapshot(snapshot, &sim->world, &sim->history);
+    snapshot->pinHits = sim->pinHits;
+    snapshot->stepTime = now;
+    snapshot->stepLength = sim->stepLength;
+
+    buffer->back = (int)(__atomic_exchange_n(&buffer->middle, (unsigned int)buffer->back | SNAPSHOT_FRESH, __ATOMIC_ACQ_REL) & 3);
+}
+
+const WorldSnapshot *LatestSnapshot(Simulation *sim) {
+    SnapshotBuffer *buffer = &sim->snapshots;
+    if (__atomic_load_n(&buffer->middle, __ATOMIC_RELAXED) & SNAPSHOT_FRESH) {
+        buffer->front = (int)(__atomic_exchange_n(&buffer->middle, (unsigned int)buffer->front, __ATOMIC_ACQ_REL) & 3);
+    }
+    return &buffer->buffers[buffer->front];
+}
+
+// ------------ Stepping ------------
+static bool Playing(const World *world) {
+    return world->state == GAMEPLAY || world->state == MINI_GAME;
+}
+
+// Applies queued commands and takes every step that is due; returns seconds until the next one
+static double RunDueSteps(Simulation *sim) {
+    double now = NowSeconds();
+    double elapsed = now - sim->lastTime;
+    sim->lastTime = now;
+
+    bool changed = false;
+    SimCommand command;
+    while (ReceiveSimCommand(&sim->commands, &command)) changed |= ApplyCommand(sim, &command);
+
+    World *world = &sim->world;
+    if (!Playing(world)) {
+        // Menus do not step; the next run starts with an empty accumulator and no history
+        sim->accumulator = 0.0;
+        sim->pendingInputs = (WorldInputs){ 0 };
+        InvalidateRenderHistory(&sim->history);
+        if (changed) PublishSnapshot(sim, now);
+        return sim->stepLength;
+    }
+
+    // Held buttons are whatever was sent last; edges wait for the next step if none is due yet
+    sim->accumulator += fmin(elapsed, SIM_MAX_CATCHUP);
+    bool stepped = false;
+    while (sim->accumulator >= sim->stepLength && Playing(world)) {
+        CaptureRenderHistory(&sim->history, world);
+        RecordedStep(&sim->recorder, world, sim->pendingInputs, sim->stepLength);
+        sim->pendingInputs.pressed = 0;
+        sim->pendingInputs.released = 0;
+        sim->accumulator -= sim->stepLength;
+        if (world->events & WORLD_EVENT_PIN_HIT) sim->pinHits++;
+        stepped = true;
+    }
+
+    if (stepped || changed) PublishSnapshot(sim, NowSeconds());
+    return sim->stepLength - sim->accumulator;
+}
+
+#if defined(SIM_THREADED)
+static void *SimulationThread(void *arg) {
+    Simulation *sim = arg;
+    while (__atomic_load_n(&sim->running, __ATOMIC_ACQUIRE)) {
+        double wait = RunDueSteps(sim);
+        SleepSeconds(fmin(wait, sim->stepLength));
+    }
+    return NULL;
+}
+#endif
+
+// ------------ Lifetime ------------
+void StartSimulation(Simulation *sim, float width, float height, int simHz, JobSystem *jobs, const char *recordFile, unsigned int seed) {
+    memset(sim, 0, sizeof(*sim));
+    InitWorld(&sim->world, width, height);
+    sim->world.jobs = jobs;
+
+    // The seed is applied whether or not the session is recorded
+    BeginRecording(&sim->recorder, &sim->world, recordFile, seed);
+
+    sim->stepLength = 1.0f / (float)((simHz > 0) ? simHz : 60);
+    sim->snapshots.back = 0;
+    sim->snapshots.middle = 1;
+    sim->snapshots.front = 2;
+    sim->lastTime = NowSeconds();
+    PublishSnapshot(sim, sim->lastTime);
+
+#if defined(SIM_THREADED)
+    sim->running = true;
+    if (pthread_create(&sim->thread, NULL, SimulationThread, sim) != 0) {
+        TraceLog(LOG_WARNING, "SIM: Could not start the simulation thread, stepping on the render thread");
+        sim->running = false;
+    }
+#endif
+}
+
+void UpdateSimulation(Simulation *sim) {
+#if defined(SIM_THREADED)
+    if (sim->running) return;
+#endif
+    RunDueSteps(sim);
+}
+
+void StopSimulation(Simulation *sim) {
+#if defined(SIM_THREADED)
+    if (sim->running) {
+        __atomic_store_n(&sim->running, false, __ATOMIC_RELEASE);
+        pthread_join(sim->thread, NULL);
+    }
+#endif
+
+    World *world = &sim->world;
+    TraceLog(LOG_INFO, "ENTITIES: Enemies peak %d of %d (%d chunk growths), bullets peak %d of %d (%d chunk growths)",
+             world->enemies.pool.peakCount, world->enemies.pool.capacity, world->enemies.pool.growths,
+             world->bullets.pool.peakCount, world->bullets.pool.capacity, world->bullets.pool.growths);
+    EndRecording(&sim->recorder);
+    UnloadWorld(world);
+    UnloadRenderHistory(&sim->history);
+    for (int i = 0; i < 3; i++) UnloadWorldSnapshot(&sim->snapshots.buffers[i]);
+}
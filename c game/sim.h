@@ -0,0 +1,86 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "world.h"
+#include "render.h"
+#include "replay.h"
+#include "jobs.h"
+
+// Builds without threads (PLATFORM_WEB) run the simulation from UpdateSimulation() instead
+#if defined(JOBS_THREADED)
+    #define SIM_THREADED 1
+#endif
+
+#define SIM_QUEUE_SIZE  256       // Commands in flight; a power of two
+#define SIM_MAX_CATCHUP 0.25      // Longer stalls are dropped instead of replayed as a burst of steps
+
+// What the render thread can ask of the simulation
+typedef enum {
+    SIM_INPUT,        // Held buttons replace the last ones; edges add up until a step takes them
+    SIM_START_RUN,
+    SIM_RETURN_MENU,
+    SIM_VIEW          // Playfield and sprite sizes
+} SimCommandType;
+
+typedef struct {
+    SimCommandType type;
+    WorldInputs    inputs;
+    Difficulty     difficulty;
+    Vector2        size;           // SIM_VIEW: playfield
+    Vector2        playerSize;     // SIM_VIEW: sprites
+    Vector2        obstacleSize;
+} SimCommand;
+
+// Single-producer single-consumer ring; each side only writes its own index
+typedef struct {
+    SimCommand items[SIM_QUEUE_SIZE];
+    unsigned int tail;                                   // Next write, render thread
+    char pad[64 - sizeof(unsigned int)];
+    unsigned int head;                                   // Next read, simulation thread
+} SimQueue;
+
+// Three snapshots: the simulation fills its back one and swaps it with the middle, the
+// renderer swaps its front one with the middle when that holds something newer. Neither side
+// waits for the other and a snapshot is never written while it is being drawn.
+typedef struct {
+    WorldSnapshot buffers[3];
+    int back;                      // Simulation thread only
+    int front;                     // Render thread only
+    unsigned int middle;           // Index of the spare buffer, | SNAPSHOT_FRESH when it is newer than front
+} SnapshotBuffer;
+
+#define SNAPSHOT_FRESH  4u
+
+// Owns the world and steps it at a fixed rate on its own thread. The world, recorder and job
+// system belong to that thread from StartSimulation() until StopSimulation() returns; the
+// render thread only sends commands and reads snapshots.
+typedef struct {
+    World          world;
+    ReplayRecorder recorder;
+    RenderHistory  history;
+    SimQueue       commands;
+    SnapshotBuffer snapshots;
+
+    float        stepLength;
+    double       lastTime;
+    double       accumulator;
+    WorldInputs  pendingInputs;
+    unsigned int pinHits;
+
+#if defined(SIM_THREADED)
+    pthread_t    thread;
+    bool         running;
+#endif
+} Simulation;
+
+// Sets up the world, starts recording to recordFile (may be NULL) and starts the thread.
+// sim must not move until StopSimulation().
+void StartSimulation(Simulation *sim, float width, float height, int simHz, JobSystem *jobs, const char *recordFile, unsigned int seed);
+void StopSimulation(Simulation *sim);      // Joins the thread, ends recording, unloads the world
+
+// Render thread. Send returns false when the queue is full; try again next frame.
+bool SendSimCommand(Simulation *sim, SimCommand command);
+const WorldSnapshot *LatestSnapshot(Simulation *sim);
+void UpdateSimulation(Simulation *sim);    // Runs due steps inline on builds without threads
+
+#endif // SIM_H
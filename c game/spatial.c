@@ -0,0 +1,112 @@
+#include "spatial.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define MIN_BUCKETS        64
+#define MAX_QUERY_BUCKETS  64   // Larger queries fall back to returning every item
+
+static unsigned int CellBucket(const SpatialHash *hash, int cx, int cy) {
+    unsigned int h = ((unsigned int)cx * 73856093u) ^ ((unsigned int)cy * 19349663u);
+    return h & (unsigned int)(hash->bucketCount - 1);
+}
+
+static int CellCoord(const SpatialHash *hash, float v) {
+    return (int)floorf(v * hash->invCellSize);
+}
+
+void InitSpatialHash(SpatialHash *hash, float cellSize) {
+    memset(hash, 0, sizeof(*hash));
+    hash->cellSize = cellSize;
+    hash->invCellSize = 1.0f / cellSize;
+}
+
+void UnloadSpatialHash(SpatialHash *hash) {
+    free(hash->bucketStart);
+    free(hash->items);
+    float cellSize = hash->cellSize;
+    InitSpatialHash(hash, cellSize);
+}
+
+void BeginSpatialHash(SpatialHash *hash, int count) {
+    // Storage only ever grows, so a steady-state tick does not allocate
+    if (count > hash->itemCapacity) {
+        free(hash->items);
+        hash->items = malloc(3 * count * sizeof(int));   // One block: sorted ids, staged ids, staged buckets
+        hash->stageIds = hash->items + count;
+        hash->stageBuckets = hash->items + 2 * count;
+        hash->itemCapacity = count;
+    }
+
+    int buckets = MIN_BUCKETS;
+    while (buckets < 2 * count) buckets *= 2;
+    if (buckets > hash->bucketCount) {
+        free(hash->bucketStart);
+        hash->bucketStart = malloc((buckets + 1) * sizeof(int));
+        hash->bucketCount = buckets;
+    }
+
+    hash->itemCount = 0;
+}
+
+void SpatialHashInsert(SpatialHash *hash, int id, Vector2 position) {
+    // Stage (id, bucket) pairs; EndSpatialHash() sorts them into buckets
+    int k = hash->itemCount++;
+    hash->stageIds[k] = id;
+    hash->stageBuckets[k] = (int)CellBucket(hash, CellCoord(hash, position.x), CellCoord(hash, position.y));
+}
+
+void EndSpatialHash(SpatialHash *hash) {
+    int n = hash->itemCount;
+    int *start = hash->bucketStart;
+
+    // Counting sort: histogram, inclusive prefix sum, then scatter
+    memset(start, 0, (hash->bucketCount + 1) * sizeof(int));
+    for (int k = 0; k < n; k++) start[hash->stageBuckets[k]]++;
+    for (int i = 1; i < hash->bucketCount; i++) start[i] += start[i - 1];
+    start[hash->bucketCount] = n;
+
+    // start[b] is one past the end of bucket b; walking backwards keeps ids in insertion order
+    // and leaves start[b] at the first slot of bucket b
+    for (int k = n - 1; k >= 0; k--) hash->items[--start[hash->stageBuckets[k]]] = hash->stageIds[k];
+}
+
+int QuerySpatialHash(const SpatialHash *hash, Vector2 center, float radius, int *results, int maxResults) {
+    if (hash->itemCount == 0) return 0;
+
+    int x0 = CellCoord(hash, center.x - radius), x1 = CellCoord(hash, center.x + radius);
+    int y0 = CellCoord(hash, center.y - radius), y1 = CellCoord(hash, center.y + radius);
+
+    unsigned int visited[MAX_QUERY_BUCKETS];
+    int visitedCount = 0;
+    int found = 0;
+
+    if ((long long)(x1 - x0 + 1) * (y1 - y0 + 1) > MAX_QUERY_BUCKETS) {
+        for (int k = 0; k < hash->itemCount; k++) {
+            if (found < maxResults) results[found] = hash->items[k];
+            found++;
+        }
+        return found;
+    }
+
+    for (int cy = y0; cy <= y1; cy++) {
+        for (int cx = x0; cx <= x1; cx++) {
+            unsigned int bucket = CellBucket(hash, cx, cy);
+
+            // Different cells can share a bucket; visit each bucket once
+            bool seen = false;
+            for (int v = 0; v < visitedCount; v++) {
+                if (visited[v] == bucket) { seen = true; break; }
+            }
+            if (seen) continue;
+            visited[visitedCount++] = bucket;
+
+            for (int k = hash->bucketStart[bucket]; k < hash->bucketStart[bucket + 1]; k++) {
+                if (found < maxResults) results[found] = hash->items[k];
+                found++;
+            }
+        }
+    }
+
+    return found;
+}
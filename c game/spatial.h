@@ -0,0 +1,34 @@
+#ifndef SPATIAL_H
+#define SPATIAL_H
+
+#include "raylib.h"
+
+// Uniform-grid spatial hash over points, rebuilt once per tick with a counting sort.
+// Cells are hashed into a power-of-two bucket table, so the playfield needs no fixed bounds.
+typedef struct {
+    float cellSize;
+    float invCellSize;
+
+    int   bucketCount;     // Power of two, at least twice the item count
+    int  *bucketStart;     // bucketCount + 1 prefix offsets into items
+    int  *items;           // Caller ids grouped by bucket
+    int  *stageIds;        // Ids in insertion order, before sorting
+    int  *stageBuckets;    // Bucket of each staged id
+    int   itemCount;
+    int   itemCapacity;
+} SpatialHash;
+
+void InitSpatialHash(SpatialHash *hash, float cellSize);
+void UnloadSpatialHash(SpatialHash *hash);
+
+// Build: BeginSpatialHash(), one SpatialHashInsert() per point, then EndSpatialHash().
+// count is an upper bound on the number of inserts that follow.
+void BeginSpatialHash(SpatialHash *hash, int count);
+void SpatialHashInsert(SpatialHash *hash, int id, Vector2 position);
+void EndSpatialHash(SpatialHash *hash);
+
+// Collects ids whose cell overlaps the circle's bounds. Candidates only: the caller does the
+// exact test. Returns how many were found; at most maxResults are written.
+int QuerySpatialHash(const SpatialHash *hash, Vector2 center, float radius, int *results, int maxResults);
+
+#endif // SPATIAL_H
@@ -0,0 +1,176 @@
+#include "steer.h"
+#include <math.h>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__GNUC__) || defined(__clang__))
+    #define STEER_X86 1
+    #include <immintrin.h>
+#endif
+
+// Scalar reference, also used for the tail the vector loops leave over
+static void SteerRange(float *x, float *y, float *vx, float *vy, const float *speed, int begin, int end, Vector2 target, float dt) {
+    for (int i = begin; i < end; i++) {
+        float dx = target.x - x[i];
+        float dy = target.y - y[i];
+        float d2 = dx*dx + dy*dy;
+        if (d2 > 0.0f) {
+            float inv = 1.0f / sqrtf(d2);
+            vx[i] = (dx * inv) * speed[i];
+            vy[i] = (dy * inv) * speed[i];
+        }
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+    }
+}
+
+void SteerEnemiesScalar(float *x, float *y, float *vx, float *vy, const float *speed, int count, Vector2 target, float dt) {
+    SteerRange(x, y, vx, vy, speed, 0, count, target, dt);
+}
+
+static void IntegrateRange(float *x, float *y, const float *vx, const float *vy, float *life, int begin, int end, Rectangle bounds, float dt) {
+    const float right = bounds.x + bounds.width, bottom = bounds.y + bounds.height;
+    for (int i = begin; i < end; i++) {
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        life[i] -= dt;
+        if (x[i] < bounds.x || x[i] > right || y[i] < bounds.y || y[i] > bottom) life[i] = 0.0f;
+    }
+}
+
+void IntegrateBulletsScalar(float *x, float *y, const float *vx, const float *vy, float *life, int count, Rectangle bounds, float dt) {
+    IntegrateRange(x, y, vx, vy, life, 0, count, bounds, dt);
+}
+
+#if defined(STEER_X86)
+static void SteerSSE2(float *x, float *y, float *vx, float *vy, const float *speed, int count, Vector2 target, float dt) {
+    const __m128 tx = _mm_set1_ps(target.x), ty = _mm_set1_ps(target.y);
+    const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), vdt = _mm_set1_ps(dt);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i), py = _mm_loadu_ps(y + i);
+        __m128 dx = _mm_sub_ps(tx, px), dy = _mm_sub_ps(ty, py);
+        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 moving = _mm_cmpgt_ps(d2, zero);
+
+        __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(d2));
+        __m128 s = _mm_loadu_ps(speed + i);
+        __m128 nvx = _mm_mul_ps(_mm_mul_ps(dx, inv), s);
+        __m128 nvy = _mm_mul_ps(_mm_mul_ps(dy, inv), s);
+
+        // Keep the old velocity where the enemy already sits on the target
+        __m128 ovx = _mm_loadu_ps(vx + i), ovy = _mm_loadu_ps(vy + i);
+        nvx = _mm_or_ps(_mm_and_ps(moving, nvx), _mm_andnot_ps(moving, ovx));
+        nvy = _mm_or_ps(_mm_and_ps(moving, nvy), _mm_andnot_ps(moving, ovy));
+
+        _mm_storeu_ps(vx + i, nvx);
+        _mm_storeu_ps(vy + i, nvy);
+        _mm_storeu_ps(x + i, _mm_add_ps(px, _mm_mul_ps(nvx, vdt)));
+        _mm_storeu_ps(y + i, _mm_add_ps(py, _mm_mul_ps(nvy, vdt)));
+    }
+    SteerRange(x, y, vx, vy, speed, i, count, target, dt);
+}
+
+__attribute__((target("avx2")))
+static void SteerAVX2(float *x, float *y, float *vx, float *vy, const float *speed, int count, Vector2 target, float dt) {
+    const __m256 tx = _mm256_set1_ps(target.x), ty = _mm256_set1_ps(target.y);
+    const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps(), vdt = _mm256_set1_ps(dt);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_loadu_ps(x + i), py = _mm256_loadu_ps(y + i);
+        __m256 dx = _mm256_sub_ps(tx, px), dy = _mm256_sub_ps(ty, py);
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 moving = _mm256_cmp_ps(d2, zero, _CMP_GT_OQ);
+
+        __m256 inv = _mm256_div_ps(one, _mm256_sqrt_ps(d2));
+        __m256 s = _mm256_loadu_ps(speed + i);
+        __m256 nvx = _mm256_mul_ps(_mm256_mul_ps(dx, inv), s);
+        __m256 nvy = _mm256_mul_ps(_mm256_mul_ps(dy, inv), s);
+
+        nvx = _mm256_blendv_ps(_mm256_loadu_ps(vx + i), nvx, moving);
+        nvy = _mm256_blendv_ps(_mm256_loadu_ps(vy + i), nvy, moving);
+
+        _mm256_storeu_ps(vx + i, nvx);
+        _mm256_storeu_ps(vy + i, nvy);
+        _mm256_storeu_ps(x + i, _mm256_add_ps(px, _mm256_mul_ps(nvx, vdt)));
+        _mm256_storeu_ps(y + i, _mm256_add_ps(py, _mm256_mul_ps(nvy, vdt)));
+    }
+    SteerRange(x, y, vx, vy, speed, i, count, target, dt);
+}
+
+static void IntegrateSSE2(float *x, float *y, const float *vx, const float *vy, float *life, int count, Rectangle bounds, float dt) {
+    const __m128 left = _mm_set1_ps(bounds.x), top = _mm_set1_ps(bounds.y);
+    const __m128 right = _mm_set1_ps(bounds.x + bounds.width), bottom = _mm_set1_ps(bounds.y + bounds.height);
+    const __m128 vdt = _mm_set1_ps(dt);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(vx + i), vdt));
+        __m128 py = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(vy + i), vdt));
+        __m128 l = _mm_sub_ps(_mm_loadu_ps(life + i), vdt);
+        __m128 out = _mm_or_ps(_mm_or_ps(_mm_cmplt_ps(px, left), _mm_cmpgt_ps(px, right)),
+                               _mm_or_ps(_mm_cmplt_ps(py, top), _mm_cmpgt_ps(py, bottom)));
+
+        _mm_storeu_ps(x + i, px);
+        _mm_storeu_ps(y + i, py);
+        _mm_storeu_ps(life + i, _mm_andnot_ps(out, l));   // All-zero bits are 0.0f
+    }
+    IntegrateRange(x, y, vx, vy, life, i, count, bounds, dt);
+}
+
+__attribute__((target("avx2")))
+static void IntegrateAVX2(float *x, float *y, const float *vx, const float *vy, float *life, int count, Rectangle bounds, float dt) {
+    const __m256 left = _mm256_set1_ps(bounds.x), top = _mm256_set1_ps(bounds.y);
+    const __m256 right = _mm256_set1_ps(bounds.x + bounds.width), bottom = _mm256_set1_ps(bounds.y + bounds.height);
+    const __m256 vdt = _mm256_set1_ps(dt);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 px = _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), vdt));
+        __m256 py = _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), vdt));
+        __m256 l = _mm256_sub_ps(_mm256_loadu_ps(life + i), vdt);
+        __m256 out = _mm256_or_ps(_mm256_or_ps(_mm256_cmp_ps(px, left, _CMP_LT_OQ), _mm256_cmp_ps(px, right, _CMP_GT_OQ)),
+                                  _mm256_or_ps(_mm256_cmp_ps(py, top, _CMP_LT_OQ), _mm256_cmp_ps(py, bottom, _CMP_GT_OQ)));
+
+        _mm256_storeu_ps(x + i, px);
+        _mm256_storeu_ps(y + i, py);
+        _mm256_storeu_ps(life + i, _mm256_andnot_ps(out, l));
+    }
+    IntegrateRange(x, y, vx, vy, life, i, count, bounds, dt);
+}
+
+static bool HasAVX2(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        __builtin_cpu_init();
+        cached = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return cached == 1;
+}
+#endif
+
+void SteerEnemies(float *x, float *y, float *vx, float *vy, const float *speed, int count, Vector2 target, float dt) {
+#if defined(STEER_X86)
+    if (HasAVX2()) SteerAVX2(x, y, vx, vy, speed, count, target, dt);
+    else SteerSSE2(x, y, vx, vy, speed, count, target, dt);
+#else
+    SteerRange(x, y, vx, vy, speed, 0, count, target, dt);
+#endif
+}
+
+void IntegrateBullets(float *x, float *y, const float *vx, const float *vy, float *life, int count, Rectangle bounds, float dt) {
+#if defined(STEER_X86)
+    if (HasAVX2()) IntegrateAVX2(x, y, vx, vy, life, count, bounds, dt);
+    else IntegrateSSE2(x, y, vx, vy, life, count, bounds, dt);
+#else
+    IntegrateRange(x, y, vx, vy, life, 0, count, bounds, dt);
+#endif
+}
+
+const char *SteerEnemiesPath(void) {
+#if defined(STEER_X86)
+    return HasAVX2() ? "avx2" : "sse2";
+#else
+    return "scalar";
+#endif
+}
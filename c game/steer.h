@@ -0,0 +1,25 @@
+#ifndef STEER_H
+#define STEER_H
+
+#include "raylib.h"
+
+// Homing kernel over structure-of-arrays enemy data: each enemy turns its velocity toward
+// target at its own speed, then integrates position by dt. Enemies sitting exactly on the
+// target keep their previous velocity.
+//
+// SteerEnemies() picks AVX2 or SSE2 at runtime and falls back to the scalar loop elsewhere.
+// Every path performs the same IEEE operations in the same order (one sqrt and one divide
+// per enemy, no FMA), so the SIMD and scalar results are bit-identical.
+void SteerEnemies(float *x, float *y, float *vx, float *vy, const float *speed, int count, Vector2 target, float dt);
+void SteerEnemiesScalar(float *x, float *y, float *vx, float *vy, const float *speed, int count, Vector2 target, float dt);
+
+// Name of the path SteerEnemies() uses on this machine: "avx2", "sse2" or "scalar"
+const char *SteerEnemiesPath(void);
+
+// Bullet kernel: integrates position by dt and counts life down by dt, then zeroes the life of
+// every bullet outside bounds, so one pass leaves each bullet to cull with life <= 0. Same
+// dispatch and bit-identical guarantee as SteerEnemies().
+void IntegrateBullets(float *x, float *y, const float *vx, const float *vy, float *life, int count, Rectangle bounds, float dt);
+void IntegrateBulletsScalar(float *x, float *y, const float *vx, const float *vy, float *life, int count, Rectangle bounds, float dt);
+
+#endif // STEER_H
@@ -0,0 +1,321 @@
+#include "stream.h"
+#include <string.h>
+
+#if defined(ASSET_STREAM_THREADED)
+    #define LOCK(s)    pthread_mutex_lock(&(s)->lock)
+    #define UNLOCK(s)  pthread_mutex_unlock(&(s)->lock)
+#else
+    #define LOCK(s)    ((void)(s))
+    #define UNLOCK(s)  ((void)(s))
+#endif
+
+// Highest-priority queued asset, marked as decoding; -1 when the queue is empty. Caller holds the lock.
+static int TakeNextAsset(AssetStreamer *streamer) {
+    int best = -1;
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        if (streamer->slots[i].status != ASSET_QUEUED) continue;
+        if (best < 0 || streamer->slots[i].priority < streamer->slots[best].priority) best = i;
+    }
+    if (best >= 0) streamer->slots[best].status = ASSET_DECODING;
+    return best;
+}
+
+// Everything that does not need the window or the audio device; runs without the lock
+static bool DecodeAsset(AssetStreamer *streamer, AssetId id, AssetSlot *out) {
+    const AssetRecipe *recipe = &assetRecipes[id];
+
+    switch (recipe->kind) {
+        case ASSET_KIND_TEXTURE:
+        case ASSET_KIND_SPRITE: {
+            out->image = GetPackedImage(streamer->pack, id);
+            if (out->image.data != NULL) {
+                // Fault the mapped pages in here rather than during the upload
+                const volatile unsigned char *pixels = out->image.data;
+                int size = GetPixelDataSize(out->image.width, out->image.height, out->image.format);
+                for (int b = 0; b < size; b += 4096) (void)pixels[b];
+            } else {
+                out->image = CookImage(id);
+            }
+            return out->image.data != NULL;
+        }
+        case ASSET_KIND_FONT: {
+            if (!FileExists(recipe->source)) return false;
+            out->fileData = LoadFileData(recipe->source, &out->fileSize);
+            return out->fileData != NULL;
+        }
+        case ASSET_KIND_SOUND: {
+            if (!FileExists(recipe->source)) return false;
+            out->wave = LoadWave(recipe->source);
+            return out->wave.data != NULL;
+        }
+    }
+    return false;
+}
+
+// Takes one queued asset and decodes it; false when there was nothing to do
+static bool DecodeNext(AssetStreamer *streamer) {
+    LOCK(streamer);
+    int id = TakeNextAsset(streamer);
+    UNLOCK(streamer);
+    if (id < 0) return false;
+
+    AssetSlot decoded = { 0 };
+    bool ok = DecodeAsset(streamer, (AssetId)id, &decoded);
+
+    LOCK(streamer);
+    AssetSlot *slot = &streamer->slots[id];
+    slot->image = decoded.image;
+    slot->fileData = decoded.fileData;
+    slot->fileSize = decoded.fileSize;
+    slot->wave = decoded.wave;
+    slot->status = ok ? ASSET_DECODED : ASSET_FAILED;
+    UNLOCK(streamer);
+
+    if (!ok) TraceLog(LOG_WARNING, "STREAM: %s missing!", assetRecipes[id].source);
+    return true;
+}
+
+#if defined(ASSET_STREAM_THREADED)
+static void *LoaderThread(void *arg) {
+    AssetStreamer *streamer = arg;
+
+    for (;;) {
+        if (DecodeNext(streamer)) continue;
+
+        LOCK(streamer);
+        bool idle = true;
+        for (int i = 0; i < ASSET_COUNT; i++) {
+            if (streamer->slots[i].status == ASSET_QUEUED) idle = false;
+        }
+        while (idle && streamer->running) {
+            pthread_cond_wait(&streamer->wake, &streamer->lock);
+            for (int i = 0; i < ASSET_COUNT; i++) {
+                if (streamer->slots[i].status == ASSET_QUEUED) idle = false;
+            }
+        }
+        bool running = streamer->running;
+        UNLOCK(streamer);
+        if (!running) break;
+    }
+    return NULL;
+}
+#endif
+
+// Frees whatever the slot holds on either side of the upload and forgets its size
+static void UnloadSlot(AssetStreamer *streamer, AssetSlot *slot) {
+    ReleaseAssetImage(streamer->pack, slot->image);
+    if (slot->fileData != NULL) UnloadFileData(slot->fileData);
+    if (slot->wave.data != NULL) UnloadWave(slot->wave);
+    if (slot->texture.id != 0) UnloadTexture(slot->texture);
+    if (slot->font.texture.id != 0) UnloadFont(slot->font);
+    if (slot->sound.frameCount > 0) UnloadSound(slot->sound);
+
+    slot->image = (Image){ 0 };
+    slot->fileData = NULL;
+    slot->fileSize = 0;
+    slot->wave = (Wave){ 0 };
+    slot->texture = (Texture2D){ 0 };
+    slot->font = (Font){ 0 };
+    slot->sound = (Sound){ 0 };
+    slot->bytes = 0;
+}
+
+static size_t AssetBytes(const AssetSlot *slot, AssetKind kind) {
+    switch (kind) {
+        case ASSET_KIND_TEXTURE: return (size_t)GetPixelDataSize(slot->texture.width, slot->texture.height, slot->texture.format);
+        case ASSET_KIND_SPRITE:  return (size_t)GetPixelDataSize(slot->image.width, slot->image.height, slot->image.format);
+        case ASSET_KIND_FONT:    return (size_t)GetPixelDataSize(slot->font.texture.width, slot->font.texture.height, slot->font.texture.format);
+        case ASSET_KIND_SOUND:   return (size_t)slot->sound.frameCount*slot->sound.stream.channels*(slot->sound.stream.sampleSize/8);
+    }
+    return 0;
+}
+
+void StartAssetStreamer(AssetStreamer *streamer, const AssetPack *pack) {
+    memset(streamer, 0, sizeof(*streamer));
+    streamer->pack = pack;
+
+#if defined(ASSET_STREAM_THREADED)
+    pthread_mutex_init(&streamer->lock, NULL);
+    pthread_cond_init(&streamer->wake, NULL);
+    streamer->running = true;
+    if (pthread_create(&streamer->thread, NULL, LoaderThread, streamer) != 0) {
+        TraceLog(LOG_WARNING, "STREAM: Could not start the loader thread, assets will load on the main thread");
+        streamer->running = false;
+    }
+#endif
+}
+
+void StopAssetStreamer(AssetStreamer *streamer) {
+#if defined(ASSET_STREAM_THREADED)
+    LOCK(streamer);
+    bool running = streamer->running;
+    streamer->running = false;
+    pthread_cond_signal(&streamer->wake);
+    UNLOCK(streamer);
+    if (running) pthread_join(streamer->thread, NULL);
+    pthread_cond_destroy(&streamer->wake);
+    pthread_mutex_destroy(&streamer->lock);
+#endif
+
+    for (int i = 0; i < ASSET_COUNT; i++) UnloadSlot(streamer, &streamer->slots[i]);
+    memset(streamer->slots, 0, sizeof(streamer->slots));
+}
+
+void RequestAssets(AssetStreamer *streamer, const AssetId *ids, int count) {
+    LOCK(streamer);
+    for (int i = 0; i < count; i++) {
+        AssetSlot *slot = &streamer->slots[ids[i]];
+        if (slot->status != ASSET_UNLOADED) continue;
+        slot->status = ASSET_QUEUED;
+        slot->priority = streamer->nextPriority++;
+    }
+#if defined(ASSET_STREAM_THREADED)
+    pthread_cond_signal(&streamer->wake);
+#endif
+    UNLOCK(streamer);
+}
+
+void PrioritizeAssets(AssetStreamer *streamer, const AssetId *ids, int count) {
+    RequestAssets(streamer, ids, count);
+
+    LOCK(streamer);
+    // Walk backwards so the list keeps its own order at the front of the queue
+    for (int i = count - 1; i >= 0; i--) {
+        AssetSlot *slot = &streamer->slots[ids[i]];
+        if (slot->status == ASSET_QUEUED) slot->priority = --streamer->frontPriority;
+    }
+    UNLOCK(streamer);
+}
+
+void PumpAssetStreamer(AssetStreamer *streamer) {
+#if defined(ASSET_STREAM_THREADED)
+    if (!streamer->running) DecodeNext(streamer);
+#else
+    DecodeNext(streamer);
+#endif
+
+    for (int i = 0; i < ASSET_COUNT; i++) {
+        AssetSlot *slot = &streamer->slots[i];
+
+        LOCK(streamer);
+        bool decoded = (slot->status == ASSET_DECODED);
+        UNLOCK(streamer);
+        if (!decoded) continue;
+
+        // The loader is done with this slot, so nothing below races with it
+        bool ok = true;
+        switch (assetRecipes[i].kind) {
+            case ASSET_KIND_TEXTURE: {
+                slot->texture = LoadTextureFromImage(slot->image);
+                ReleaseAssetImage(streamer->pack, slot->image);
+                slot->image = (Image){ 0 };
+                ok = (slot->texture.id != 0);
+            } break;
+            case ASSET_KIND_SPRITE: break;    // Stays on the CPU for the atlas
+            case ASSET_KIND_FONT: {
+                slot->font = LoadFontFromMemory(GetFileExtension(assetRecipes[i].source), slot->fileData, slot->fileSize, 32, NULL, 0);
+                UnloadFileData(slot->fileData);
+                slot->fileData = NULL;
+                ok = (slot->font.texture.id != 0);
+            } break;
+            case ASSET_KIND_SOUND: {
+                slot->sound = LoadSoundFromWave(slot->wave);
+                UnloadWave(slot->wave);
+                slot->wave = (Wave){ 0 };
+                ok = (slot->sound.frameCount > 0);
+            } break;
+        }
+
+        slot->bytes = AssetBytes(slot, assetRecipes[i].kind);
+        slot->lastUsed = ++streamer->useClock;
+
+        LOCK(streamer);
+        slot->status = ok ? ASSET_READY : ASSET_FAILED;
+        UNLOCK(streamer);
+    }
+}
+
+void AcquireAssets(AssetStreamer *streamer, const AssetId *ids, int count) {
+    for (int i = 0; i < count; i++) streamer->slots[ids[i]].refs++;
+    RequestAssets(streamer, ids, count);
+}
+
+void ReleaseAssets(AssetStreamer *streamer, const AssetId *ids, int count) {
+    for (int i = 0; i < count; i++) {
+        AssetSlot *slot = &streamer->slots[ids[i]];
+        if (slot->refs > 0 && --slot->refs == 0) slot->lastUsed = ++streamer->useClock;
+    }
+}
+
+void TrimAssetCache(AssetStreamer *streamer, size_t budget) {
+    for (;;) {
+        size_t cached = 0;
+        int oldest = -1;
+        for (int i = 0; i < ASSET_COUNT; i++) {
+            AssetSlot *slot = &streamer->slots[i];
+            if (slot->refs > 0 || GetAssetStatus(streamer, (AssetId)i) != ASSET_READY) continue;
+            cached += slot->bytes;
+            if (oldest < 0 || slot->lastUsed < streamer->slots[oldest].lastUsed) oldest = i;
+        }
+        if (cached <= budget || oldest < 0) return;
+
+        TraceLog(LOG_INFO, "STREAM: Evicted %s (%.1f KB)", assetRecipes[oldest].name, streamer->slots[oldest].bytes / 1024.0);
+        UnloadSlot(streamer, &streamer->slots[oldest]);
+
+        // Ready slots are never touched by the loader, so only the status change needs the lock
+        LOCK(streamer);
+        streamer->slots[oldest].status = ASSET_UNLOADED;
+        UNLOCK(streamer);
+    }
+}
+
+AssetMemory GetAssetMemory(AssetStreamer *streamer, const AssetId *ids, int count) {
+    AssetMemory memory = { 0 };
+    for (int k = 0; k < ((ids != NULL) ? count : ASSET_COUNT); k++) {
+        int i = (ids != NULL) ? (int)ids[k] : k;
+        const AssetSlot *slot = &streamer->slots[i];
+        if (GetAssetStatus(streamer, (AssetId)i) != ASSET_READY) continue;
+
+        switch (assetRecipes[i].kind) {
+            case ASSET_KIND_TEXTURE:
+            case ASSET_KIND_FONT:   memory.textureBytes += slot->bytes; break;
+            case ASSET_KIND_SOUND:  memory.audioBytes += slot->bytes; break;
+            case ASSET_KIND_SPRITE: memory.imageBytes += slot->bytes; break;
+        }
+        if (slot->refs == 0) memory.cachedBytes += slot->bytes;
+    }
+    return memory;
+}
+
+AssetStatus GetAssetStatus(AssetStreamer *streamer, AssetId id) {
+    LOCK(streamer);
+    AssetStatus status = streamer->slots[id].status;
+    UNLOCK(streamer);
+    return status;
+}
+
+bool AssetsSettled(AssetStreamer *streamer, const AssetId *ids, int count) {
+    for (int i = 0; i < count; i++) {
+        AssetStatus status = GetAssetStatus(streamer, ids[i]);
+        if (status != ASSET_READY && status != ASSET_FAILED) return false;
+    }
+    return true;
+}
+
+// Main-thread fields below are only written by PumpAssetStreamer(), so they need no lock
+Texture2D GetStreamedTexture(AssetStreamer *streamer, AssetId id) {
+    return streamer->slots[id].texture;
+}
+
+Font GetStreamedFont(AssetStreamer *streamer, AssetId id) {
+    return streamer->slots[id].font;
+}
+
+Sound GetStreamedSound(AssetStreamer *streamer, AssetId id) {
+    return streamer->slots[id].sound;
+}
+
+Image GetStreamedImage(AssetStreamer *streamer, AssetId id) {
+    if (GetAssetStatus(streamer, id) != ASSET_READY) return (Image){ 0 };
+    return streamer->slots[id].image;
+}
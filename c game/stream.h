@@ -0,0 +1,97 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "raylib.h"
+#include "assets.h"
+#include <stdbool.h>
+
+// Builds without threads (PLATFORM_WEB) decode on the main thread, one asset per pump
+#if !defined(PLATFORM_WEB)
+    #define ASSET_STREAM_THREADED 1
+    #include <pthread.h>
+#endif
+
+typedef enum {
+    ASSET_UNLOADED,
+    ASSET_QUEUED,       // Waiting for the loader thread
+    ASSET_DECODING,     // Loader thread is working on it
+    ASSET_DECODED,      // CPU data ready, waiting for the main thread to upload it
+    ASSET_READY,
+    ASSET_FAILED        // Missing or unreadable; the scene keeps drawing its placeholder
+} AssetStatus;
+
+typedef struct {
+    AssetStatus status;
+    int         priority;     // Lower is picked first
+
+    // Produced by the loader thread, consumed by the main thread
+    Image          image;     // Texture and sprite assets
+    unsigned char *fileData;  // Fonts
+    int            fileSize;
+    Wave           wave;      // Sounds
+
+    // Owned by the main thread
+    Texture2D texture;
+    Font      font;
+    Sound     sound;
+    int       refs;           // Scenes holding it; at zero it is cached until evicted
+    unsigned int lastUsed;    // Use clock when the last reference went away
+    size_t    bytes;          // Resident size once ready
+} AssetSlot;
+
+typedef struct {
+    size_t textureBytes;      // GPU: textures and font atlases
+    size_t audioBytes;
+    size_t imageBytes;        // CPU: sprite images waiting for or kept next to the atlas
+    size_t cachedBytes;       // Part of the above with no scene referencing it
+} AssetMemory;
+
+// One loader thread decodes queued assets (PNG decode, resize, WAV decode, file reads) while
+// the main thread keeps drawing; PumpAssetStreamer() then does the GPU and audio uploads,
+// which raylib only allows on the thread that owns the window.
+typedef struct {
+    AssetSlot slots[ASSET_COUNT];
+    const AssetPack *pack;     // Packed images skip decoding; may be empty
+    int nextPriority;
+    int frontPriority;
+    unsigned int useClock;
+
+#if defined(ASSET_STREAM_THREADED)
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    bool            running;
+#endif
+} AssetStreamer;
+
+void StartAssetStreamer(AssetStreamer *streamer, const AssetPack *pack);
+void StopAssetStreamer(AssetStreamer *streamer);    // Joins the thread and unloads everything
+
+// Queues whatever is not loaded yet behind everything already queued
+void RequestAssets(AssetStreamer *streamer, const AssetId *ids, int count);
+// Moves these ahead of everything else still queued, for the scene about to be shown
+void PrioritizeAssets(AssetStreamer *streamer, const AssetId *ids, int count);
+
+// Main thread, once per frame: uploads everything the loader has finished
+void PumpAssetStreamer(AssetStreamer *streamer);
+
+// Reference counting, main thread only. Acquiring queues anything not loaded; releasing the
+// last reference keeps the asset resident as cache until TrimAssetCache() needs the room.
+void AcquireAssets(AssetStreamer *streamer, const AssetId *ids, int count);
+void ReleaseAssets(AssetStreamer *streamer, const AssetId *ids, int count);
+
+// Unloads unreferenced assets, least recently used first, until the cache fits in budget bytes
+void TrimAssetCache(AssetStreamer *streamer, size_t budget);
+// Resident bytes over the given assets, or over every asset when ids is NULL
+AssetMemory GetAssetMemory(AssetStreamer *streamer, const AssetId *ids, int count);
+
+AssetStatus GetAssetStatus(AssetStreamer *streamer, AssetId id);
+bool AssetsSettled(AssetStreamer *streamer, const AssetId *ids, int count);   // All ready or failed
+
+// Loaded objects, or zeroed ones (texture id 0, frameCount 0, image data NULL) until ready
+Texture2D GetStreamedTexture(AssetStreamer *streamer, AssetId id);
+Font      GetStreamedFont(AssetStreamer *streamer, AssetId id);
+Sound     GetStreamedSound(AssetStreamer *streamer, AssetId id);
+Image     GetStreamedImage(AssetStreamer *streamer, AssetId id);
+
+#endif // STREAM_H
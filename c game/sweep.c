@@ -0,0 +1,61 @@
+#include "sweep.h"
+#include <math.h>
+
+float SweepCircles(Vector2 a0, Vector2 a1, Vector2 b0, Vector2 b1, float radius) {
+    // b relative to a: p + d t for t in [0, 1]
+    float px = b0.x - a0.x, py = b0.y - a0.y;
+    float dx = (b1.x - b0.x) - (a1.x - a0.x), dy = (b1.y - b0.y) - (a1.y - a0.y);
+
+    float c = px*px + py*py - radius*radius;
+    if (c <= 0.0f) return 0.0f;
+    float a = dx*dx + dy*dy;
+    float b = px*dx + py*dy;
+    if (a <= 0.0f || b >= 0.0f) return -1.0f;   // Not closing in
+
+    float discriminant = b*b - a*c;
+    if (discriminant < 0.0f) return -1.0f;
+    float t = (-b - sqrtf(discriminant)) / a;
+    return (t <= 1.0f) ? t : -1.0f;
+}
+
+float SweepSegmentRect(Vector2 from, Vector2 to, Rectangle rect) {
+    // Slabs: the segment is inside the rectangle while it is inside both axes' ranges
+    float enter = 0.0f, leave = 1.0f;
+    const float start[2] = { from.x, from.y }, delta[2] = { to.x - from.x, to.y - from.y };
+    const float low[2] = { rect.x, rect.y }, high[2] = { rect.x + rect.width, rect.y + rect.height };
+    for (int axis = 0; axis < 2; axis++) {
+        if (delta[axis] == 0.0f) {
+            if (start[axis] < low[axis] || start[axis] > high[axis]) return -1.0f;
+            continue;
+        }
+        float t0 = (low[axis] - start[axis]) / delta[axis], t1 = (high[axis] - start[axis]) / delta[axis];
+        if (t0 > t1) { float swap = t0; t0 = t1; t1 = swap; }
+        if (t0 > enter) enter = t0;
+        if (t1 < leave) leave = t1;
+        if (enter > leave) return -1.0f;
+    }
+    return enter;
+}
+
+static float Earliest(float a, float b) {
+    if (a < 0.0f) return b;
+    if (b < 0.0f) return a;
+    return (a < b) ? a : b;
+}
+
+float SweepCircleRect(Vector2 from, Vector2 to, float radius, Rectangle rect) {
+    if (radius <= 0.0f) return SweepSegmentRect(from, to, rect);
+
+    // The rectangle grown by radius with rounded corners: two crossed rectangles and a circle
+    // on every corner, entered at the earliest of the six
+    float t = SweepSegmentRect(from, to, (Rectangle){ rect.x - radius, rect.y, rect.width + 2.0f * radius, rect.height });
+    t = Earliest(t, SweepSegmentRect(from, to, (Rectangle){ rect.x, rect.y - radius, rect.width, rect.height + 2.0f * radius }));
+    if (t == 0.0f) return t;
+
+    const Vector2 corners[4] = {
+        { rect.x, rect.y }, { rect.x + rect.width, rect.y },
+        { rect.x, rect.y + rect.height }, { rect.x + rect.width, rect.y + rect.height }
+    };
+    for (int k = 0; k < 4; k++) t = Earliest(t, SweepCircles(corners[k], corners[k], from, to, radius));
+    return t;
+}
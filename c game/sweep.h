@@ -0,0 +1,20 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "raylib.h"
+
+// Continuous collision: shapes moving in a straight line over one step, with times given as a
+// fraction of the step, 0 at its start and 1 at its end. Each test returns the earliest time
+// the shapes touch, 0 when they already overlap at the start, or -1 when they never do.
+
+// Circles a and b moving from a0 to a1 and from b0 to b1, touching once their centres come
+// within radius (the two radii added up)
+float SweepCircles(Vector2 a0, Vector2 a1, Vector2 b0, Vector2 b1, float radius);
+
+// A point moving from `from` to `to` against a rectangle
+float SweepSegmentRect(Vector2 from, Vector2 to, Rectangle rect);
+
+// A circle moving from `from` to `to` against a rectangle
+float SweepCircleRect(Vector2 from, Vector2 to, float radius, Rectangle rect);
+
+#endif // SWEEP_H
@@ -0,0 +1,54 @@
+#include "timing.h"
+
+// Kept out of the header so <windows.h> never meets raylib.h in the same translation unit
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define PSAPI_VERSION 2      // K32GetProcessMemoryInfo lives in kernel32, no -lpsapi needed
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <time.h>
+    #include <sys/resource.h>
+#endif
+
+double NowSeconds(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+void SleepSeconds(double seconds) {
+    if (seconds <= 0.0) return;
+#if defined(_WIN32)
+    Sleep((DWORD)(seconds * 1000.0));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, NULL);
+#endif
+}
+
+size_t PeakRssBytes(void) {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    #if defined(__APPLE__)
+        return (size_t)usage.ru_maxrss;           // Bytes on macOS
+    #else
+        return (size_t)usage.ru_maxrss * 1024;    // Kilobytes on Linux and the BSDs
+    #endif
+#endif
+}
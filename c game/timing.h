@@ -0,0 +1,15 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stddef.h>
+
+// Monotonic wall clock in seconds for headless tools; raylib's GetTime() needs an open window
+double NowSeconds(void);
+
+// Blocks the calling thread for about that long; threads pacing themselves without a window
+void SleepSeconds(double seconds);
+
+// Largest resident set the process has had so far, in bytes; 0 where the OS cannot tell
+size_t PeakRssBytes(void);
+
+#endif // TIMING_H
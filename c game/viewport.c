@@ -0,0 +1,99 @@
+#include "viewport.h"
+#include <math.h>
+
+// ------------ Virtual screen ------------
+void LoadVirtualScreen(VirtualScreen *screen, int width, int height) {
+    screen->target = LoadRenderTexture(width, height);
+    screen->width = width;
+    screen->height = height;
+    screen->scale = 1.0f;
+    if (screen->target.id != 0) SetTextureFilter(screen->target.texture, TEXTURE_FILTER_BILINEAR);
+}
+
+void UnloadVirtualScreen(VirtualScreen *screen) {
+    if (screen->target.id != 0) UnloadRenderTexture(screen->target);
+    *screen = (VirtualScreen){ 0 };
+}
+
+void BeginVirtualScreen(VirtualScreen *screen, float scale) {
+    screen->scale = scale;
+    BeginTextureMode(screen->target);
+    BeginMode2D((Camera2D){ .zoom = scale });
+}
+
+void EndVirtualScreen(VirtualScreen *screen) {
+    EndMode2D();
+    EndTextureMode();
+}
+
+Rectangle VirtualViewport(int width, int height, int windowWidth, int windowHeight) {
+    float fit = fminf((float)windowWidth / (float)width, (float)windowHeight / (float)height);
+    float w = (float)width * fit, h = (float)height * fit;
+    return (Rectangle){ ((float)windowWidth - w) / 2.0f, ((float)windowHeight - h) / 2.0f, w, h };
+}
+
+void DrawVirtualScreen(const VirtualScreen *screen) {
+    ClearBackground(BLACK);
+    if (screen->target.id == 0) return;
+
+    // Render textures are stored bottom-up: the drawn corner is the texture's bottom rows,
+    // and a negative height flips them back
+    float w = (float)screen->width * screen->scale, h = (float)screen->height * screen->scale;
+    Rectangle source = { 0, (float)screen->target.texture.height - h, w, -h };
+    Rectangle dest = VirtualViewport(screen->width, screen->height, GetScreenWidth(), GetScreenHeight());
+    DrawTexturePro(screen->target.texture, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+}
+
+void MapMouseToVirtual(const VirtualScreen *screen) {
+    Rectangle view = VirtualViewport(screen->width, screen->height, GetScreenWidth(), GetScreenHeight());
+    SetMouseOffset((int)-view.x, (int)-view.y);
+    SetMouseScale((float)screen->width / view.width, (float)screen->height / view.height);
+}
+
+// ------------ Dynamic resolution ------------
+void InitResolutionController(ResolutionController *controller, float budget) {
+    *controller = (ResolutionController){ 0 };
+    controller->budget = budget;
+    controller->average = budget;
+    controller->probeFrames = RESOLUTION_PROBE_FRAMES;
+}
+
+float ResolutionScale(const ResolutionController *controller) {
+    return 1.0f - RESOLUTION_STEP * (float)controller->level;
+}
+
+float UpdateResolutionScale(ResolutionController *controller, float frameTime) {
+    ResolutionController *c = controller;
+    c->average += (frameTime - c->average) * RESOLUTION_SMOOTHING;
+
+    if (c->average > c->budget * RESOLUTION_OVER) {
+        c->overFrames++;
+        c->onBudgetFrames = 0;
+    } else {
+        c->overFrames = 0;
+        c->onBudgetFrames = (c->average <= c->budget * RESOLUTION_ON_BUDGET) ? c->onBudgetFrames + 1 : 0;
+    }
+
+    // A step up that held for a full wait has found real headroom
+    if (c->probing && c->onBudgetFrames >= c->probeFrames) {
+        c->probing = false;
+        c->probeFrames = RESOLUTION_PROBE_FRAMES;
+    }
+
+    if (c->overFrames >= RESOLUTION_OVER_FRAMES && c->level < RESOLUTION_LEVELS - 1) {
+        if (c->probing) {
+            c->probing = false;
+            c->probeFrames = (c->probeFrames * 2 < RESOLUTION_PROBE_MAX) ? c->probeFrames * 2 : RESOLUTION_PROBE_MAX;
+        }
+        c->level++;
+        c->changes++;
+        c->overFrames = c->onBudgetFrames = 0;
+        c->average = c->budget;    // Judge the new level on its own frames
+    } else if (c->onBudgetFrames >= c->probeFrames && c->level > 0) {
+        c->level--;
+        c->changes++;
+        c->probing = true;
+        c->overFrames = c->onBudgetFrames = 0;
+    }
+    return ResolutionScale(c);
+}
@@ -0,0 +1,70 @@
+#ifndef VIEWPORT_H
+#define VIEWPORT_H
+
+#include "raylib.h"
+#include <stdbool.h>
+
+// Everything is laid out and simulated in this resolution, whatever the window's size
+#define VIRTUAL_WIDTH   800
+#define VIRTUAL_HEIGHT  600
+
+// ------------ Virtual screen ------------
+// The frame is drawn into an offscreen target in virtual coordinates, then scaled into the
+// window with letterboxing. At a render scale below 1 only the target's top-left
+// scale x scale portion is drawn, so fewer pixels are shaded, and it is stretched back up.
+typedef struct {
+    RenderTexture2D target;   // Virtual size; id 0 when it could not be created
+    int   width;
+    int   height;
+    float scale;              // Of the frame last begun
+} VirtualScreen;
+
+void LoadVirtualScreen(VirtualScreen *screen, int width, int height);
+void UnloadVirtualScreen(VirtualScreen *screen);
+
+// Between these, draw in virtual coordinates. Offscreen rendering of its own (cached layers,
+// queued text) has to happen outside.
+void BeginVirtualScreen(VirtualScreen *screen, float scale);
+void EndVirtualScreen(VirtualScreen *screen);
+
+// Within BeginDrawing(): the last frame, scaled to fit the window and centred on black
+void DrawVirtualScreen(const VirtualScreen *screen);
+
+// Where the virtual screen lands in a window of the given size, keeping its aspect
+Rectangle VirtualViewport(int width, int height, int windowWidth, int windowHeight);
+
+// Makes GetMousePosition() report virtual coordinates for the current window size
+void MapMouseToVirtual(const VirtualScreen *screen);
+
+// ------------ Dynamic resolution ------------
+#define RESOLUTION_LEVELS        6      // Render scales 1.0 down to 0.5
+#define RESOLUTION_STEP          0.1f
+#define RESOLUTION_SMOOTHING     0.1f   // Weight of each new frame in the running average
+#define RESOLUTION_OVER          1.02f  // An average this far over budget...
+#define RESOLUTION_OVER_FRAMES   10     // ...for this many frames in a row drops a level
+#define RESOLUTION_ON_BUDGET     1.01f  // An average within this of budget counts as keeping up
+#define RESOLUTION_PROBE_FRAMES  120    // Frames kept up before trying a level higher
+#define RESOLUTION_PROBE_MAX     960   // Each probe that fails straight away doubles the wait, up to this
+
+// Picks the render scale from measured frame times. A frame capped by vsync or the limiter
+// never reads under budget, so it cannot tell how much headroom there is: once frames have
+// kept up for a while it probes a level higher, and backs off for longer every time a probe
+// runs over at once.
+typedef struct {
+    float budget;             // Seconds a frame may take
+    float average;            // Smoothed frame time
+    int   level;              // 0 is full resolution
+    int   overFrames;         // In a row over budget
+    int   onBudgetFrames;     // In a row keeping up
+    int   probeFrames;        // Current wait before probing
+    bool  probing;            // The last change was a step up still on trial
+    int   changes;
+} ResolutionController;
+
+void  InitResolutionController(ResolutionController *controller, float budget);
+float ResolutionScale(const ResolutionController *controller);
+
+// Feeds one frame's duration; returns the scale for the next frame
+float UpdateResolutionScale(ResolutionController *controller, float frameTime);
+
+#endif // VIEWPORT_H
@@ -0,0 +1,1023 @@
+#include "world.h"
+#include "raymath.h"
+#include "steer.h"
+#include "sweep.h"
+#include "profile.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+const float ELIXIR_DURATION = 8.0f;   // Elixir lasts 8 seconds
+#define BOWLING_TUNED_HZ 60.0f   // Bowling rates below are per frame at this rate
+
+// Batch sizes for the parallel passes; small swarms end up as one batch and run inline
+#define JOB_GRAIN_CHUNKS   4       // Entity chunks per batch for the streaming kernels
+#define JOB_GRAIN_ENEMIES  512     // Enemies per batch for the contact queries
+
+#define CHUNK_COUNT(count)  (((count) + ENTITY_CHUNK_SIZE - 1) / ENTITY_CHUNK_SIZE)
+
+// ------------ Helpers ------------
+static void ResetElixirState(World *world) {
+    world->elixirAvailable = false;
+    world->elixirReady = false;
+    world->elixirSpawnTimer = 0.0f;
+    world->elixirDurationTimer = 0.0f;
+}
+
+static void ResetGame(World *world) {
+    world->playerPos = (Vector2){400, 300};
+    world->score = 0;
+    world->gameOver = false;
+    ClearEntityPool(&world->enemies.pool);
+    ClearEntityPool(&world->bullets.pool);
+    ClearObstacles(&world->obstacles);
+    world->emitterCount = 0;
+    world->weaponVolleys = 0;
+    ResetElixirState(world);
+}
+
+// ------------ Entity storage ------------
+static void GrowEnemies(World *world) {
+    Enemies *enemies = &world->enemies;
+    int c = GrowEntityPool(&enemies->pool);
+    enemies->chunks = realloc(enemies->chunks, enemies->pool.chunkTableSize * sizeof(EnemyChunk *));
+    enemies->chunks[c] = ArenaAlloc(&world->arena, sizeof(EnemyChunk));
+    world->enemyContacts = realloc(world->enemyContacts, enemies->pool.capacity * sizeof(int));
+}
+
+static void GrowBullets(World *world) {
+    Bullets *bullets = &world->bullets;
+    int c = GrowEntityPool(&bullets->pool);
+    bullets->chunks = realloc(bullets->chunks, bullets->pool.chunkTableSize * sizeof(BulletChunk *));
+    bullets->chunks[c] = ArenaAlloc(&world->arena, sizeof(BulletChunk));
+    world->hitCandidates = realloc(world->hitCandidates, (size_t)bullets->pool.capacity * world->hitCandidateRows * sizeof(int));
+}
+
+// One row of query scratch per worker that may run CollideEnemies() at once
+static void ReserveHitRows(World *world, int rows) {
+    if (rows <= world->hitCandidateRows) return;
+    world->hitCandidateRows = rows;
+    world->hitCandidates = realloc(world->hitCandidates, (size_t)world->bullets.pool.capacity * rows * sizeof(int));
+}
+
+static void RemoveEnemy(Enemies *enemies, int i) {
+    int last = RemoveEntity(&enemies->pool, i);
+    if (last != i) {
+        ENTITY_AT(enemies, x, i) = ENTITY_AT(enemies, x, last);
+        ENTITY_AT(enemies, y, i) = ENTITY_AT(enemies, y, last);
+        ENTITY_AT(enemies, vx, i) = ENTITY_AT(enemies, vx, last);
+        ENTITY_AT(enemies, vy, i) = ENTITY_AT(enemies, vy, last);
+        ENTITY_AT(enemies, speed, i) = ENTITY_AT(enemies, speed, last);
+    }
+}
+
+static void RemoveBullet(Bullets *bullets, int i) {
+    int last = RemoveEntity(&bullets->pool, i);
+    if (last != i) {
+        ENTITY_AT(bullets, x, i) = ENTITY_AT(bullets, x, last);
+        ENTITY_AT(bullets, y, i) = ENTITY_AT(bullets, y, last);
+        ENTITY_AT(bullets, vx, i) = ENTITY_AT(bullets, vx, last);
+        ENTITY_AT(bullets, vy, i) = ENTITY_AT(bullets, vy, last);
+        ENTITY_AT(bullets, life, i) = ENTITY_AT(bullets, life, last);
+    }
+}
+
+// ------------ Gameplay ------------
+void SpawnEnemyAt(World *world, Vector2 pos) {
+    Enemies *enemies = &world->enemies;
+    if (enemies->pool.count == enemies->pool.capacity) GrowEnemies(world);
+    int i = SpawnEntity(&enemies->pool);
+
+    float baseSpeed = 50.0f;
+    float speed = baseSpeed;
+    if (world->difficulty == DIFFICULTY_MEDIUM) speed = baseSpeed * 1.7f;
+    if (world->difficulty == DIFFICULTY_HARD)   speed = baseSpeed * 2.0f;
+
+    Vector2 velocity = Vector2Scale(Vector2Normalize(Vector2Subtract(world->playerPos, pos)), speed);
+    ENTITY_AT(enemies, x, i) = pos.x;
+    ENTITY_AT(enemies, y, i) = pos.y;
+    ENTITY_AT(enemies, vx, i) = velocity.x;
+    ENTITY_AT(enemies, vy, i) = velocity.y;
+    ENTITY_AT(enemies, speed, i) = speed;
+}
+
+// One draw per enemy: the whole part picks the side, the fraction the point along it
+void SpawnEnemyBurst(World *world, int count) {
+    float draws[256];
+    while (count > 0) {
+        int n = (count < 256) ? count : 256;
+        FillRandomFloats(&world->random[RANDOM_SPAWN], draws, n, 0.0f, 4.0f);
+        for (int i = 0; i < n; i++) {
+            int side = (int)draws[i];
+            float along = draws[i] - (float)side;
+            Vector2 pos;
+            switch (side) {
+                case 0: pos = (Vector2){0, along * world->height}; break;
+                case 1: pos = (Vector2){world->width, along * world->height}; break;
+                case 2: pos = (Vector2){along * world->width, 0}; break;
+                default: pos = (Vector2){along * world->width, world->height}; break;
+            }
+            SpawnEnemyAt(world, pos);
+        }
+        count -= n;
+    }
+}
+
+static Rectangle PlayerRectAt(const World *world, Vector2 centre) {
+    return (Rectangle){
+        centre.x - world->playerSize.x/2.0f,
+        centre.y - world->playerSize.y/2.0f,
+        world->playerSize.x,
+        world->playerSize.y
+    };
+}
+
+static Rectangle PlayerRect(const World *world) {
+    return PlayerRectAt(world, world->playerPos);
+}
+
+static Rectangle Inflate(Rectangle rect, float margin) {
+    return (Rectangle){ rect.x - margin, rect.y - margin, rect.width + 2.0f * margin, rect.height + 2.0f * margin };
+}
+
+// Rocks anywhere past the top-left margin, none within OBSTACLE_CLEARANCE of the player. Rock
+// centres sit at least 1.5 rock diagonals apart, which leaves lanes between them.
+static void SpawnObstacles(World *world) {
+    Rectangle keepClear = Inflate(PlayerRect(world), OBSTACLE_CLEARANCE);
+
+    Vector2 size = world->obstacleSize;
+    float spacing = 1.5f * sqrtf(size.x*size.x + size.y*size.y);
+    Rectangle area = { 100.0f, 100.0f, world->width - 100.0f, world->height - 100.0f };
+    PlaceObstacles(&world->obstacles, &world->random[RANDOM_OBSTACLES], area, size, spacing, keepClear, world->hardObstacles);
+}
+
+void SpawnBulletAt(World *world, Vector2 pos, Vector2 velocity, float life) {
+    Bullets *bullets = &world->bullets;
+    if (bullets->pool.count == bullets->pool.capacity) GrowBullets(world);
+    int i = SpawnEntity(&bullets->pool);
+
+    ENTITY_AT(bullets, x, i) = pos.x;
+    ENTITY_AT(bullets, y, i) = pos.y;
+    ENTITY_AT(bullets, vx, i) = velocity.x;
+    ENTITY_AT(bullets, vy, i) = velocity.y;
+    ENTITY_AT(bullets, life, i) = life;
+}
+
+int AddEmitter(World *world, const BulletPattern *pattern, Vector2 position, Vector2 facing) {
+    if (world->emitterCount == MAX_EMITTERS || pattern == NULL || pattern->interval <= 0.0f) return -1;
+    world->emitters[world->emitterCount] = (Emitter){ pattern, position, facing, 0.0f, 0 };
+    return world->emitterCount++;
+}
+
+// One volley from origin; AIMED patterns aim at the player
+static void FirePattern(World *world, const BulletPattern *pattern, Vector2 origin, Vector2 facing, int volley) {
+    Vector2 velocities[PATTERN_MAX_VOLLEY];
+    int count = PatternVolley(pattern, facing, Vector2Subtract(world->playerPos, origin), volley, velocities);
+    for (int i = 0; i < count; i++) SpawnBulletAt(world, origin, velocities[i], pattern->lifetime);
+}
+
+static void ShootBullet(World *world) {
+    FirePattern(world, world->weapon, world->playerPos, (Vector2){ 0, -1 }, world->weaponVolleys++);
+}
+
+static void StepEmitters(World *world, float dt) {
+    for (int e = 0; e < world->emitterCount; e++) {
+        Emitter *emitter = &world->emitters[e];
+        emitter->timer -= dt;
+        while (emitter->timer <= 0.0f) {
+            FirePattern(world, emitter->pattern, emitter->position, emitter->facing, emitter->volleys++);
+            emitter->timer += emitter->pattern->interval;
+        }
+    }
+}
+
+static void LayoutPins(World *world) {
+    BowlingLane lane = BowlingLaneFor(world->width, world->height);
+    RackPins(world->pins, &lane);
+}
+
+static void ResetBowling(World *world) {
+    world->ballPos = (Vector2){ world->width/2.0f, world->height - 80.0f };
+    world->t = 0.0f;
+    world->ballSpeed = 0.0f;
+    world->throwAngle = 0.0f;
+    world->ballLaunched = false;
+    world->power = 0.0f;
+    world->charging = false;
+    world->strikeMode = false;
+    world->luckyStrike = false;
+    world->settleTime = 0.0f;
+    LayoutPins(world);
+}
+
+static void RebuildBulletHash(World *world) {
+    // Keyed by slot rather than dense index: kills swap-remove bullets during the
+    // collision pass, but a live bullet keeps its slot. Each bullet goes in at the middle of
+    // this tick's path, so a query padded by the longest half-path finds every path nearby.
+    const Bullets *bullets = &world->bullets;
+    SpatialHash *hash = &world->bulletHash;
+    float half = 0.5f * world->tickLength, reach2 = 0.0f;
+    BeginSpatialHash(hash, bullets->pool.count);
+    for (int i = 0; i < bullets->pool.count; i++) {
+        float vx = ENTITY_AT(bullets, vx, i), vy = ENTITY_AT(bullets, vy, i);
+        SpatialHashInsert(hash, EntityDenseToSlot(&bullets->pool, i), (Vector2){ ENTITY_AT(bullets, x, i) - vx * half, ENTITY_AT(bullets, y, i) - vy * half });
+        if (vx*vx + vy*vy > reach2) reach2 = vx*vx + vy*vy;
+    }
+    EndSpatialHash(hash);
+    world->bulletReach = sqrtf(reach2) * half;
+}
+
+// Player got caught: Hard mode gets one bowling round to earn a revive
+static void PlayerHit(World *world) {
+    if (world->godMode) return;
+    if (world->difficulty == DIFFICULTY_HARD && !world->secondChanceUsed) {
+        ResetBowling(world);
+        ResetElixirState(world);
+        world->state = MINI_GAME;
+    } else {
+        world->gameOver = true;
+        world->state = CLOSING_SCENE;
+    }
+}
+
+// Where an entity moving at velocity started this tick; it moves in a straight line to where it is now
+static Vector2 TickStart(const World *world, Vector2 position, Vector2 velocity) {
+    return (Vector2){ position.x - velocity.x * world->tickLength, position.y - velocity.y * world->tickLength };
+}
+
+// The bullet whose path meets a circle moving from `from` to `to` earliest this tick, with that time
+static int FindBulletHitWith(const World *world, Vector2 from, Vector2 to, float radius, int *candidates, float *time) {
+    Vector2 middle = { 0.5f * (from.x + to.x), 0.5f * (from.y + to.y) };
+    float halfPath = 0.5f * sqrtf((to.x - from.x) * (to.x - from.x) + (to.y - from.y) * (to.y - from.y));
+    int count = QuerySpatialHash(&world->bulletHash, middle, radius + BULLET_RADIUS + halfPath + world->bulletReach,
+                                 candidates, world->bullets.pool.capacity);
+
+    // A bullet's whole path lies within two half-paths of where it is now: anything further
+    // out is dropped on its position alone, before its velocity is loaded
+    float near = radius + BULLET_RADIUS + halfPath + 2.0f * world->bulletReach;
+
+    // Candidates come back in bucket order; ties go to the lowest slot so the result does not
+    // depend on how the hash happened to lay them out
+    const Bullets *bullets = &world->bullets;
+    int hitSlot = -1, hit = -1;
+    float best = -1.0f;
+    for (int k = 0; k < count; k++) {
+        int slot = candidates[k];
+        if (best == 0.0f && slot > hitSlot) continue;      // Nothing beats touching from the start but a lower slot
+        int j = EntitySlotToDense(&bullets->pool, slot);   // -1 once an earlier enemy took it
+        if (j < 0) continue;
+
+        Vector2 end = { ENTITY_AT(bullets, x, j), ENTITY_AT(bullets, y, j) };
+        float dx = end.x - middle.x, dy = end.y - middle.y;
+        if (dx*dx + dy*dy > near*near) continue;
+
+        Vector2 start = TickStart(world, end, (Vector2){ ENTITY_AT(bullets, vx, j), ENTITY_AT(bullets, vy, j) });
+        float t = SweepCircles(from, to, start, end, radius + BULLET_RADIUS);
+        if (t < 0.0f) continue;
+        if (hit < 0 || t < best || (t == best && slot < hitSlot)) {
+            best = t;
+            hitSlot = slot;
+            hit = j;
+        }
+    }
+    *time = best;
+    return hit;
+}
+
+// ------------ Parallel jobs ------------
+// Each job writes only the entities in its own chunks, so batches can run in any order
+typedef struct {
+    World *world;
+    float  dt;
+} StepJob;
+
+// Leaves every bullet that expired, left the playfield or hit a rock with life <= 0
+static void MoveBulletsJob(void *context, int begin, int end, int worker) {
+    StepJob *job = context;
+    Bullets *bullets = &job->world->bullets;
+    const ObstacleMap *rocks = &job->world->obstacles;
+    Rectangle bounds = { 0.0f, 0.0f, job->world->width, job->world->height };
+    for (int c = begin; c < end; c++) {
+        BulletChunk *chunk = bullets->chunks[c];
+        int base = c * ENTITY_CHUNK_SIZE;
+        int n = (bullets->pool.count - base < ENTITY_CHUNK_SIZE) ? bullets->pool.count - base : ENTITY_CHUNK_SIZE;
+        IntegrateBullets(chunk->x, chunk->y, chunk->vx, chunk->vy, chunk->life, n, bounds, job->dt);
+
+        if (rocks->count == 0) continue;
+        for (int k = 0; k < n; k++) {
+            if (chunk->life[k] <= 0.0f) continue;
+            Vector2 end = { chunk->x[k], chunk->y[k] };
+            Vector2 start = TickStart(job->world, end, (Vector2){ chunk->vx[k], chunk->vy[k] });
+            if (ObstacleSweepCircle(rocks, start, end, BULLET_RADIUS) >= 0.0f) chunk->life[k] = 0.0f;
+        }
+    }
+}
+
+static void SteerEnemiesJob(void *context, int begin, int end, int worker) {
+    StepJob *job = context;
+    Enemies *enemies = &job->world->enemies;
+    const ObstacleMap *rocks = &job->world->obstacles;
+    for (int c = begin; c < end; c++) {
+        EnemyChunk *chunk = enemies->chunks[c];
+        int base = c * ENTITY_CHUNK_SIZE;
+        int n = (enemies->pool.count - base < ENTITY_CHUNK_SIZE) ? enemies->pool.count - base : ENTITY_CHUNK_SIZE;
+        if (job->world->difficulty == DIFFICULTY_HARD) {
+            SteerEnemiesFlow(&job->world->flow, chunk->x, chunk->y, chunk->vx, chunk->vy, chunk->speed, n, job->world->playerPos, job->dt);
+        } else {
+            SteerEnemies(chunk->x, chunk->y, chunk->vx, chunk->vy, chunk->speed, n, job->world->playerPos, job->dt);
+        }
+
+        // Whoever the field could not guide (spawned inside a rock's margin, or homing) slides off the rock
+        if (rocks->count == 0) continue;
+        for (int k = 0; k < n; k++) {
+            Vector2 p = PushOutOfObstacles(rocks, (Vector2){ chunk->x[k], chunk->y[k] }, ENEMY_RADIUS);
+            chunk->x[k] = p.x;
+            chunk->y[k] = p.y;
+        }
+    }
+}
+
+#define CONTACT_NONE    -1
+#define CONTACT_PLAYER  -2
+
+// What enemy i runs into first along this tick's paths: the player or a bullet's slot
+static int FindContact(const World *world, int i, int *candidates) {
+    const Enemies *enemies = &world->enemies;
+    Vector2 to = { ENTITY_AT(enemies, x, i), ENTITY_AT(enemies, y, i) };
+    Vector2 from = TickStart(world, to, (Vector2){ ENTITY_AT(enemies, vx, i), ENTITY_AT(enemies, vy, i) });
+
+    float playerTime = SweepCircles(from, to, world->playerFrom, world->playerPos, ENEMY_RADIUS + 20);
+    if (playerTime == 0.0f) return CONTACT_PLAYER;   // Already touching: no bullet can come first
+
+    float bulletTime;
+    int hit = FindBulletHitWith(world, from, to, ENEMY_RADIUS, candidates, &bulletTime);
+    if (playerTime >= 0.0f && (hit < 0 || playerTime <= bulletTime)) return CONTACT_PLAYER;
+    return (hit >= 0) ? EntityDenseToSlot(&world->bullets.pool, hit) : CONTACT_NONE;
+}
+
+// Read-only pass: what each enemy would hit if nothing else had been resolved this tick
+static void FindContactsJob(void *context, int begin, int end, int worker) {
+    StepJob *job = context;
+    World *world = job->world;
+    int *candidates = world->hitCandidates + (size_t)worker * world->bullets.pool.capacity;
+
+    for (int i = begin; i < end; i++) {
+        world->enemyContacts[EntityDenseToSlot(&world->enemies.pool, i)] = FindContact(world, i, candidates);
+    }
+}
+
+// Applies the contacts in the order a single-threaded pass would meet them: enemies in dense
+// order, a removed enemy's slot revisited with the one swapped into it. An enemy whose bullet
+// went to an earlier enemy looks again, which finds what the serial pass would.
+static void CollideEnemies(World *world) {
+    Enemies *enemies = &world->enemies;
+    Bullets *bullets = &world->bullets;
+
+    for (int i = 0; i < enemies->pool.count; ) {
+        int contact = world->enemyContacts[EntityDenseToSlot(&enemies->pool, i)];
+        if (contact >= 0 && EntitySlotToDense(&bullets->pool, contact) < 0) contact = FindContact(world, i, world->hitCandidates);
+        if (contact == CONTACT_PLAYER) {
+            // In godMode the run goes on, so the enemies after this one still meet their bullets
+            if (world->godMode) {
+                i++;
+                continue;
+            }
+            PlayerHit(world);
+            break;
+        }
+
+        if (contact >= 0) {
+            RemoveEnemy(enemies, i);
+            RemoveBullet(bullets, EntitySlotToDense(&bullets->pool, contact));
+            world->score++;
+        } else {
+            i++;
+        }
+    }
+}
+
+// ------------ Scenes ------------
+static void StepGameplay(World *world, WorldInputs inputs, float dt) {
+    if (world->gameOver) return;
+
+    // Hard keeps the world as each tick begins, for the second chance to resume from
+    if (world->difficulty == DIFFICULTY_HARD && !world->secondChanceUsed && !world->godMode) SaveWorldCheckpoint(world, &world->resume);
+
+    PROFILE_BEGIN(PROFILE_INPUT);
+    world->tickLength = dt;
+    world->playerFrom = world->playerPos;
+    float delta_x = 0.0f;
+    if (inputs.down & INPUT_LEFT)  delta_x -= world->playerSpeed * dt;
+    if (inputs.down & INPUT_RIGHT) delta_x += world->playerSpeed * dt;
+    float delta_y = 0.0f;
+    if (inputs.down & INPUT_UP)    delta_y -= world->playerSpeed * dt;
+    if (inputs.down & INPUT_DOWN)  delta_y += world->playerSpeed * dt;
+    world->playerPos.x += delta_x;
+    world->playerPos.y += delta_y;
+
+    if (inputs.pressed & INPUT_FIRE) ShootBullet(world);
+    PROFILE_END(PROFILE_INPUT);
+
+    PROFILE_BEGIN(PROFILE_BULLETS);
+    StepEmitters(world, dt);
+    StepJob job = { world, dt };
+    Bullets *bullets = &world->bullets;
+    ParallelFor(world->jobs, CHUNK_COUNT(bullets->pool.count), JOB_GRAIN_CHUNKS, MoveBulletsJob, &job);
+
+    // Back to front, so the bullet swapped into a hole has already been checked and survives
+    for (int i = bullets->pool.count - 1; i >= 0; i--) {
+        if (ENTITY_AT(bullets, life, i) <= 0.0f) RemoveBullet(bullets, i);
+    }
+    RebuildBulletHash(world);
+    PROFILE_END(PROFILE_BULLETS);
+
+    PROFILE_BEGIN(PROFILE_SPAWN);
+    float spawnInterval = (world->difficulty == DIFFICULTY_EASY) ? 1.5f :
+                          (world->difficulty == DIFFICULTY_MEDIUM) ? 1.0f : 0.7f;
+    world->enemySpawnTimer += dt;
+    if (world->enemySpawnTimer > spawnInterval - (world->score * 0.01f)) {
+        SpawnEnemyBurst(world, 1);
+        world->enemySpawnTimer = 0;
+    }
+    PROFILE_END(PROFILE_SPAWN);
+
+    // Elixir spawn logic
+    PROFILE_BEGIN(PROFILE_ELIXIR);
+    if (world->difficulty != DIFFICULTY_EASY && !world->elixirAvailable && !world->elixirReady && world->elixirSpawnInterval > 0.0f) {
+        world->elixirSpawnTimer += dt;
+        if (world->elixirSpawnTimer >= world->elixirSpawnInterval) {
+            world->elixirSpawnTimer = 0.0f;
+            float margin = 50.0f; // Adjusted for 100x100 elixir
+            world->elixirPos.x = RandomInt(&world->random[RANDOM_ELIXIR], (int)margin, (int)world->width - (int)margin);
+            world->elixirPos.y = RandomInt(&world->random[RANDOM_ELIXIR], (int)margin, (int)world->height - (int)margin);
+            world->elixirAvailable = true;
+            world->elixirDurationTimer = 0.0f;
+        }
+    }
+
+    // Elixir duration and collection
+    if (world->elixirAvailable) {
+        world->elixirDurationTimer += dt;
+        if (world->elixirDurationTimer >= ELIXIR_DURATION) {
+            world->elixirAvailable = false;
+            world->elixirDurationTimer = 0.0f;
+        } else {
+            float pickupRadius = 50.0f; // Match 100x100 visual size
+            if (CheckCollisionCircles(world->playerPos, 20.0f, world->elixirPos, pickupRadius)) {
+                world->elixirAvailable = false;
+                world->elixirReady = true;
+                world->elixirDurationTimer = 0.0f;
+            }
+        }
+    }
+
+    // Use elixir to destroy all enemies
+    if (world->elixirReady && (inputs.pressed & INPUT_SPECIAL)) {
+        ClearEntityPool(&world->enemies.pool);
+        world->elixirReady = false;
+    }
+    PROFILE_END(PROFILE_ELIXIR);
+
+    // Steer and move the whole live swarm in one vectorized pass; on Hard the swarm follows a
+    // flow field around the rocks instead, rebuilt only when the player changes cell
+    Enemies *enemies = &world->enemies;
+    PROFILE_BEGIN(PROFILE_STEER);
+    if (world->difficulty == DIFFICULTY_HARD) {
+        const ObstacleMap *rocks = &world->obstacles;
+        UpdateFlowField(&world->flow, world->width, world->height, rocks->rects, rocks->count, ENEMY_RADIUS, rocks->version, world->playerPos);
+    }
+    ParallelFor(world->jobs, CHUNK_COUNT(enemies->pool.count), JOB_GRAIN_CHUNKS, SteerEnemiesJob, &job);
+    PROFILE_END(PROFILE_STEER);
+
+    // Contacts in parallel, then applied in serial order so kills and score do not depend on threads
+    PROFILE_BEGIN(PROFILE_COLLIDE);
+    ReserveHitRows(world, JobWorkerCount(world->jobs));
+    ParallelFor(world->jobs, enemies->pool.count, JOB_GRAIN_ENEMIES, FindContactsJob, &job);
+    CollideEnemies(world);
+
+    Vector2 moved = { world->playerPos.x - world->playerFrom.x, world->playerPos.y - world->playerFrom.y };
+    if (ObstacleSweepRect(&world->obstacles, PlayerRectAt(world, world->playerFrom), moved) >= 0.0f) PlayerHit(world);
+    PROFILE_END(PROFILE_COLLIDE);
+}
+
+static void RemoveEnemiesNear(World *world, Vector2 center, float radius) {
+    Enemies *enemies = &world->enemies;
+    for (int i = enemies->pool.count - 1; i >= 0; i--) {
+        float dx = ENTITY_AT(enemies, x, i) - center.x, dy = ENTITY_AT(enemies, y, i) - center.y;
+        if (dx*dx + dy*dy < radius * radius) RemoveEnemy(enemies, i);
+    }
+}
+
+// Steps the player back out of the clearance rocks are placed with, so a run that ended on a
+// rock does not resume pressed against it. Rocks closer together than the clearance cannot
+// all be cleared; the player then only has to end up off every rock, with a gap, since the
+// rock sweep counts touching as a hit.
+static void MoveClearOfRocks(World *world) {
+    for (int pass = 0; pass < REVIVE_ROCK_PASSES; pass++) {
+        Vector2 push = PushRectOutOfObstacles(&world->obstacles, Inflate(PlayerRect(world), OBSTACLE_CLEARANCE));
+        if (push.x == 0.0f && push.y == 0.0f) return;
+        world->playerPos = Vector2Add(world->playerPos, push);
+    }
+    for (int pass = 0; pass < REVIVE_ROCK_PASSES; pass++) {
+        Vector2 push = PushRectOutOfObstacles(&world->obstacles, Inflate(PlayerRect(world), REVIVE_ROCK_GAP));
+        if (push.x == 0.0f && push.y == 0.0f) return;
+        world->playerPos = Vector2Add(world->playerPos, push);
+    }
+}
+
+// A strike in the second chance: back to the world as the fatal tick began, minus the enemies
+// closing in and with the player stepped clear of the rocks. The tick count keeps running;
+// only the game state goes back.
+static void ResumeRun(World *world) {
+    unsigned long long tick = world->tick;
+    if (RestoreWorldCheckpoint(world, &world->resume)) {
+        MoveClearOfRocks(world);
+        RemoveEnemiesNear(world, world->playerPos, REVIVE_CLEAR_RADIUS);
+    } else {
+        ResetGame(world);
+        if (world->difficulty == DIFFICULTY_HARD) SpawnObstacles(world);
+    }
+    world->tick = tick;
+    world->secondChanceUsed = true;
+    world->state = GAMEPLAY;
+}
+
+static void StepMiniGame(World *world, WorldInputs inputs, float dt) {
+    // Scale the per-frame bowling rates to this step's length
+    float frames = dt * BOWLING_TUNED_HZ;
+
+    PROFILE_BEGIN(PROFILE_BOWLING);
+    // Toggle strike mode
+    if ((inputs.pressed & INPUT_SPECIAL) && !world->ballLaunched) {
+        world->strikeMode = !world->strikeMode;
+        if (world->strikeMode) {
+            world->luckyStrike = (RandomInt(&world->random[RANDOM_BOWLING], 0, 1) == 1);
+        }
+    }
+
+    // Adjust angle
+    if (!world->ballLaunched) {
+        if (inputs.down & INPUT_LEFT) world->throwAngle -= 0.02f * frames;
+        if (inputs.down & INPUT_RIGHT) world->throwAngle += 0.02f * frames;
+        world->throwAngle = Clamp(world->throwAngle, -world->bowling.maxAngle, world->bowling.maxAngle);
+        world->ballPos.x = world->width/2.0f + sinf(world->throwAngle) * world->bowling.pathA;
+        world->ballPos.y = world->height - 80.0f;
+    }
+
+    // Power charging
+    if ((inputs.down & INPUT_FIRE) && !world->ballLaunched) {
+        world->charging = true;
+        world->power += 0.01f * frames;
+        world->power = Clamp(world->power, 0.0f, world->bowling.maxPower);
+    }
+    if ((inputs.released & INPUT_FIRE) && world->charging) {
+        world->charging = false;
+        world->ellipseCenter = BowlingLaneFor(world->width, world->height).pathCentre;
+        world->ballLaunched = true;
+        world->t = 0.0f;
+        world->ballSpeed = BowlingBallSpeed(&world->bowling, world->power);
+        world->ballPos = BowlingBallAt(&world->bowling, world->ellipseCenter, world->throwAngle, world->t);
+    }
+    PROFILE_END(PROFILE_BOWLING);
+
+    // Ball flight and pin physics. Steps longer than a 60 Hz frame run in frame-sized slices so
+    // the ball cannot jump over a pin. At 60 Hz this is exactly what EvaluateThrow() steps.
+    PROFILE_SCOPE(PROFILE_PINS)
+    if (world->ballLaunched) {
+        BowlingThrow bowl = { world->throwAngle, world->power, world->strikeMode, world->luckyStrike };
+        bool strike = IsStrikeThrow(&world->bowling, bowl);
+
+        int slices = (int)ceilf(frames);
+        for (int s = 0; s < slices; s++) {
+            float slice = frames / slices;
+            bool inPlay = world->t < PI / 2;
+            Vector2 from = world->ballPos;
+            if (inPlay) {
+                world->t += world->ballSpeed * slice;
+                world->ballPos = BowlingBallAt(&world->bowling, world->ellipseCenter, world->throwAngle, world->t);
+            } else {
+                world->settleTime += slice;
+            }
+            if (StepPins(&world->bowling, world->pins, from, world->ballPos, inPlay, strike, slice)) world->events |= WORLD_EVENT_PIN_HIT;
+        }
+
+        // Ball gone and the pins settled
+        if (world->t >= PI / 2 && (PinsAsleep(world->pins) || world->settleTime >= PIN_SETTLE_LIMIT)) {
+            world->lastKnocked = FallenPins(world->pins);
+            if (world->lastKnocked == ALL_PINS) {
+                ResumeRun(world);
+            } else {
+                world->gameOver = true;
+                world->state = CLOSING_SCENE;
+            }
+            ResetBowling(world);
+        }
+    }
+}
+
+// ------------ API ------------
+void InitWorld(World *world, float width, float height) {
+    memset(world, 0, sizeof(*world));
+    world->state = OPENING_SCENE;
+    world->difficulty = DIFFICULTY_MEDIUM;
+    world->width = width;
+    world->height = height;
+    world->playerSize = (Vector2){79, 78};     // pikachu.png
+    world->obstacleSize = (Vector2){95, 50};   // Rock.png at a third of its size
+    world->playerPos = (Vector2){400, 300};
+    world->playerSpeed = 200.0f;
+    InitArena(&world->arena, 256*1024);
+    InitEntityPool(&world->enemies.pool, &world->arena);
+    InitEntityPool(&world->bullets.pool, &world->arena);
+    world->hitCandidateRows = 1;
+    while (world->enemies.pool.capacity < ENEMY_RESERVE) GrowEnemies(world);
+    while (world->bullets.pool.capacity < BULLET_RESERVE) GrowBullets(world);
+    world->enemies.pool.growths = 0;   // Only growth past the reserve is interesting
+    world->bullets.pool.growths = 0;
+    InitSpatialHash(&world->bulletHash, 32.0f);
+    InitFlowField(&world->flow, FLOW_CELL_SIZE);
+    InitObstacleMap(&world->obstacles);
+    world->hardObstacles = HARD_OBSTACLES;
+    world->weapon = FindBulletPattern("shot");
+    world->bowling = DefaultBowlingRules();
+    ResetBowling(world);
+    ResetElixirState(world);
+    SeedWorld(world, 0);
+}
+
+void SeedWorld(World *world, unsigned long long seed) {
+    for (int s = 0; s < RANDOM_STREAMS; s++) SeedRandomStream(&world->random[s], seed, (unsigned int)s);
+}
+
+void UnloadWorld(World *world) {
+    UnloadEntityPool(&world->enemies.pool);
+    UnloadEntityPool(&world->bullets.pool);
+    free(world->enemies.chunks);
+    free(world->bullets.chunks);
+    free(world->hitCandidates);
+    free(world->enemyContacts);
+    UnloadSpatialHash(&world->bulletHash);
+    UnloadFlowField(&world->flow);
+    UnloadObstacleMap(&world->obstacles);
+    UnloadWorldCheckpoint(&world->resume);
+    UnloadArena(&world->arena);
+}
+
+void StartRun(World *world, Difficulty difficulty) {
+    world->difficulty = difficulty;
+    ResetGame(world);
+    if (difficulty == DIFFICULTY_HARD) SpawnObstacles(world);
+    world->elixirSpawnInterval = (difficulty == DIFFICULTY_MEDIUM) ? 5.0f : (difficulty == DIFFICULTY_HARD) ? 7.0f : 0.0f;
+    world->secondChanceUsed = false;
+    world->state = GAMEPLAY;
+}
+
+void ReturnToMenu(World *world) {
+    ResetGame(world);
+    world->secondChanceUsed = false;
+    world->state = OPENING_SCENE;
+}
+
+int FindBulletHit(World *world, Vector2 center, float radius) {
+    float time;
+    return FindBulletHitWith(world, center, center, radius, world->hitCandidates, &time);
+}
+
+void StepWorld(World *world, WorldInputs inputs, float dt) {
+    world->events = 0;
+
+    switch (world->state) {
+        case GAMEPLAY:  StepGameplay(world, inputs, dt); break;
+        case MINI_GAME: StepMiniGame(world, inputs, dt); break;
+        default: break;   // Menus are driven by the shell
+    }
+
+    world->tick++;
+}
+
+// ------------ Hashing ------------
+// FNV-1a over each field separately, so struct padding never leaks into the hash
+static unsigned long long HashBytes(unsigned long long hash, const void *data, size_t size) {
+    const unsigned char *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+#define HASH_FIELD(hash, field) ((hash) = HashBytes((hash), &(field), sizeof(field)))
+
+unsigned long long HashWorld(const World *world) {
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+
+    HASH_FIELD(hash, world->state);
+    HASH_FIELD(hash, world->difficulty);
+    HASH_FIELD(hash, world->tick);
+    HASH_FIELD(hash, world->playerPos);
+    HASH_FIELD(hash, world->score);
+    HASH_FIELD(hash, world->gameOver);
+    HASH_FIELD(hash, world->secondChanceUsed);
+    HASH_FIELD(hash, world->enemySpawnTimer);
+    HASH_FIELD(hash, world->random);
+
+    HASH_FIELD(hash, world->elixirAvailable);
+    HASH_FIELD(hash, world->elixirPos);
+    HASH_FIELD(hash, world->elixirReady);
+    HASH_FIELD(hash, world->elixirSpawnTimer);
+    HASH_FIELD(hash, world->elixirDurationTimer);
+
+    for (int i = 0; i < world->enemies.pool.count; i++) {
+        HASH_FIELD(hash, ENTITY_AT(&world->enemies, x, i));
+        HASH_FIELD(hash, ENTITY_AT(&world->enemies, y, i));
+        HASH_FIELD(hash, ENTITY_AT(&world->enemies, vx, i));
+        HASH_FIELD(hash, ENTITY_AT(&world->enemies, vy, i));
+    }
+    for (int i = 0; i < world->bullets.pool.count; i++) {
+        HASH_FIELD(hash, ENTITY_AT(&world->bullets, x, i));
+        HASH_FIELD(hash, ENTITY_AT(&world->bullets, y, i));
+        HASH_FIELD(hash, ENTITY_AT(&world->bullets, vx, i));
+        HASH_FIELD(hash, ENTITY_AT(&world->bullets, vy, i));
+        HASH_FIELD(hash, ENTITY_AT(&world->bullets, life, i));
+    }
+    for (int e = 0; e < world->emitterCount; e++) {
+        HASH_FIELD(hash, world->emitters[e].timer);
+        HASH_FIELD(hash, world->emitters[e].volleys);
+    }
+    HASH_FIELD(hash, world->weaponVolleys);
+    HASH_FIELD(hash, world->obstacles.count);
+    for (int i = 0; i < world->obstacles.count; i++) HASH_FIELD(hash, world->obstacles.rects[i]);
+
+    HASH_FIELD(hash, world->ballPos);
+    HASH_FIELD(hash, world->t);
+    HASH_FIELD(hash, world->throwAngle);
+    HASH_FIELD(hash, world->ellipseCenter);
+    HASH_FIELD(hash, world->ballSpeed);
+    HASH_FIELD(hash, world->ballLaunched);
+    HASH_FIELD(hash, world->power);
+    HASH_FIELD(hash, world->charging);
+    HASH_FIELD(hash, world->strikeMode);
+    HASH_FIELD(hash, world->luckyStrike);
+    HASH_FIELD(hash, world->settleTime);
+    for (int i = 0; i < NUM_PINS; i++) {
+        HASH_FIELD(hash, world->pins[i].position);
+        HASH_FIELD(hash, world->pins[i].velocity);
+        HASH_FIELD(hash, world->pins[i].rotation);
+        HASH_FIELD(hash, world->pins[i].restTime);
+        HASH_FIELD(hash, world->pins[i].fallen);
+        HASH_FIELD(hash, world->pins[i].asleep);
+    }
+
+    return hash;
+}
+
+// ------------ Checkpoints ------------
+// One walk over the state serves both directions, so saving and restoring cannot drift apart.
+// Restoring walks twice: a check pass into a copy of the world that only steps over what the
+// world points at, then, if the whole blob held up, the pass that writes.
+typedef struct {
+    WorldCheckpoint *checkpoint;    // Saving: grown as the fields go in
+    const unsigned char *source;    // Restoring
+    size_t size;
+    size_t pos;
+    bool   saving;
+    bool   checking;                // Restoring into a copy: heap memory is left alone
+    bool   corrupt;                 // Restoring found a field it cannot use; the rest is skipped
+} Transfer;
+
+static void ReserveCheckpoint(WorldCheckpoint *checkpoint, size_t size) {
+    if (size <= checkpoint->capacity) return;
+    size_t capacity = (checkpoint->capacity > 0) ? checkpoint->capacity * 2 : 4096;
+    while (capacity < size) capacity *= 2;
+    checkpoint->data = realloc(checkpoint->data, capacity);
+    checkpoint->capacity = capacity;
+}
+
+static void TransferBytes(Transfer *t, void *field, size_t size) {
+    if (t->saving) {
+        ReserveCheckpoint(t->checkpoint, t->pos + size);
+        memcpy(t->checkpoint->data + t->pos, field, size);
+    } else {
+        if (t->corrupt || size > t->size - t->pos) {
+            t->corrupt = true;
+            return;
+        }
+        memcpy(field, t->source + t->pos, size);
+    }
+    t->pos += size;
+}
+
+static void TransferSkip(Transfer *t, size_t size) {
+    if (t->corrupt || size > t->size - t->pos) t->corrupt = true;
+    else t->pos += size;
+}
+
+// Memory the world points at rather than holds; a check pass only steps over it
+static void TransferBlock(Transfer *t, void *block, size_t size) {
+    if (t->checking) TransferSkip(t, size);
+    else TransferBytes(t, block, size);
+}
+
+#define TRANSFER_FIELD(t, field) TransferBytes((t), &(field), sizeof(field))
+
+// Keeps arrays that are read in place on an 8-byte boundary
+static void TransferAlign(Transfer *t) {
+    static unsigned char zeros[8];
+    size_t pad = (8 - (t->pos & 7)) & 7;
+    if (t->saving) TransferBytes(t, zeros, pad);
+    else TransferSkip(t, pad);
+}
+
+// Every slot's bookkeeping, free-slot order included, so later spawns land in the same slots.
+// Chunks grown since the save go back to how a fresh chunk starts.
+static void TransferPool(Transfer *t, EntityPool *pool, int capacity) {
+    int chunks = capacity / ENTITY_CHUNK_SIZE;
+    for (int c = 0; c < chunks; c++) TransferBlock(t, t->checking ? NULL : pool->chunks[c], sizeof(PoolChunk));
+    if (t->saving || t->checking) return;
+
+    for (int c = chunks; c < pool->chunkCount; c++) {
+        PoolChunk *chunk = pool->chunks[c];
+        for (int k = 0; k < ENTITY_CHUNK_SIZE; k++) {
+            chunk->denseToSlot[k] = chunk->slotToDense[k] = c * ENTITY_CHUNK_SIZE + k;
+            chunk->generation[k] = 0;
+        }
+    }
+}
+
+static int LiveInChunk(int count, int c) {
+    int left = count - c * ENTITY_CHUNK_SIZE;
+    return (left < ENTITY_CHUNK_SIZE) ? left : ENTITY_CHUNK_SIZE;
+}
+
+// A pool's live count and capacity; the writing pass of a restore grows the pool to fit
+static void TransferPoolSize(Transfer *t, World *world, EntityPool *pool, void (*grow)(World *), int *count, int *capacity) {
+    TransferBytes(t, count, sizeof(*count));
+    TransferBytes(t, capacity, sizeof(*capacity));
+    if (*capacity < 0 || *capacity % ENTITY_CHUNK_SIZE != 0 || *count < 0 || *count > *capacity) t->corrupt = true;
+    if (t->saving || t->checking || t->corrupt) return;
+    while (pool->capacity < *capacity) grow(world);
+    pool->count = *count;
+}
+
+static void TransferEnemies(Transfer *t, World *world) {
+    Enemies *enemies = &world->enemies;
+    int count = enemies->pool.count, capacity = enemies->pool.capacity;
+    TransferPoolSize(t, world, &enemies->pool, GrowEnemies, &count, &capacity);
+    if (t->corrupt) return;
+
+    TransferPool(t, &enemies->pool, capacity);
+    for (int c = 0; c < CHUNK_COUNT(count); c++) {
+        EnemyChunk *chunk = t->checking ? NULL : enemies->chunks[c];
+        size_t bytes = LiveInChunk(count, c) * sizeof(float);
+        TransferBlock(t, chunk ? chunk->x : NULL, bytes);
+        TransferBlock(t, chunk ? chunk->y : NULL, bytes);
+        TransferBlock(t, chunk ? chunk->vx : NULL, bytes);
+        TransferBlock(t, chunk ? chunk->vy : NULL, bytes);
+        TransferBlock(t, chunk ? chunk->speed : NULL, bytes);
+    }
+}
+
+static void TransferBullets(Transfer *t, World *world) {
+    Bullets *bullets = &world->bullets;
+    int count = bullets->pool.count, capacity = bullets->pool.capacity;
+    TransferPoolSize(t, world, &bullets->pool, GrowBullets, &count, &capacity);
+    if (t->corrupt) return;
+
+    TransferPool(t, &bullets->pool, capacity);
+    for (int c = 0; c < CHUNK_COUNT(count); c++) {
+        BulletChunk *chunk = t->checking ? NULL : bullets->chunks[c];
+        size_t bytes = LiveInChunk(count, c) * sizeof(float);
+        TransferBlock(t, chunk ? chunk->x : NULL, bytes);
+        TransferBlock(t, chunk ? chunk->y : NULL, bytes);
+        TransferBlock(t, chunk ? chunk->vx : NULL, bytes);
+        TransferBlock(t, chunk ? chunk->vy : NULL, bytes);
+        TransferBlock(t, chunk ? chunk->life : NULL, bytes);
+    }
+}
+
+// Patterns go by their place in the table rather than by address; only the weapon may be none
+static void TransferPattern(Transfer *t, const BulletPattern **pattern, bool optional) {
+    int id = BulletPatternId(*pattern);
+    TRANSFER_FIELD(t, id);
+    if (t->saving || t->corrupt) return;
+    *pattern = BulletPatternById(id);
+    if (*pattern == NULL && !(optional && id == -1)) t->corrupt = true;
+}
+
+static void TransferWorld(Transfer *t, World *world) {
+    TRANSFER_FIELD(t, world->state);
+    TRANSFER_FIELD(t, world->difficulty);
+    TRANSFER_FIELD(t, world->tick);
+    TRANSFER_FIELD(t, world->width);
+    TRANSFER_FIELD(t, world->height);
+    TRANSFER_FIELD(t, world->playerSize);
+    TRANSFER_FIELD(t, world->obstacleSize);
+    TRANSFER_FIELD(t, world->godMode);
+
+    TRANSFER_FIELD(t, world->playerPos);
+    TRANSFER_FIELD(t, world->playerSpeed);
+    TRANSFER_FIELD(t, world->score);
+    TRANSFER_FIELD(t, world->gameOver);
+    TRANSFER_FIELD(t, world->secondChanceUsed);
+    TRANSFER_FIELD(t, world->enemySpawnTimer);
+    TRANSFER_FIELD(t, world->random);
+
+    TRANSFER_FIELD(t, world->elixirAvailable);
+    TRANSFER_FIELD(t, world->elixirPos);
+    TRANSFER_FIELD(t, world->elixirReady);
+    TRANSFER_FIELD(t, world->elixirSpawnTimer);
+    TRANSFER_FIELD(t, world->elixirDurationTimer);
+    TRANSFER_FIELD(t, world->elixirSpawnInterval);
+
+    TRANSFER_FIELD(t, world->emitterCount);
+    if (world->emitterCount < 0 || world->emitterCount > MAX_EMITTERS) t->corrupt = true;
+    for (int e = 0; e < world->emitterCount && !t->corrupt; e++) {
+        Emitter *emitter = &world->emitters[e];
+        TransferPattern(t, &emitter->pattern, false);
+        TRANSFER_FIELD(t, emitter->position);
+        TRANSFER_FIELD(t, emitter->facing);
+        TRANSFER_FIELD(t, emitter->timer);
+        TRANSFER_FIELD(t, emitter->volleys);
+    }
+    TransferPattern(t, &world->weapon, true);
+    TRANSFER_FIELD(t, world->weaponVolleys);
+    TRANSFER_FIELD(t, world->hardObstacles);
+
+    TRANSFER_FIELD(t, world->bowling);
+    TRANSFER_FIELD(t, world->pins);
+    TRANSFER_FIELD(t, world->ballPos);
+    TRANSFER_FIELD(t, world->t);
+    TRANSFER_FIELD(t, world->throwAngle);
+    TRANSFER_FIELD(t, world->ellipseCenter);
+    TRANSFER_FIELD(t, world->ballSpeed);
+    TRANSFER_FIELD(t, world->ballLaunched);
+    TRANSFER_FIELD(t, world->power);
+    TRANSFER_FIELD(t, world->charging);
+    TRANSFER_FIELD(t, world->strikeMode);
+    TRANSFER_FIELD(t, world->luckyStrike);
+    TRANSFER_FIELD(t, world->settleTime);
+
+    // Rocks are compared in place and only replaced, tree and version with them, when they differ
+    int rocks = world->obstacles.count;
+    TRANSFER_FIELD(t, rocks);
+    TransferAlign(t);
+    if (t->saving) {
+        TransferBytes(t, world->obstacles.rects, rocks * sizeof(Rectangle));
+    } else if (!t->corrupt) {
+        size_t bytes = (size_t)rocks * sizeof(Rectangle);
+        if (rocks < 0 || bytes > t->size - t->pos) t->corrupt = true;
+        else if (!t->checking) SetObstacles(&world->obstacles, (const Rectangle *)(t->source + t->pos), rocks);
+        TransferSkip(t, bytes);
+    }
+
+    TransferEnemies(t, world);
+    TransferBullets(t, world);
+
+    // Between the fatal hit and the throw, the world to resume is part of the state
+    if (world->state == MINI_GAME) {
+        unsigned long long resumeSize = world->resume.size;
+        TRANSFER_FIELD(t, resumeSize);
+        if (!t->saving && !t->corrupt && resumeSize > t->size - t->pos) t->corrupt = true;
+        if (!t->saving && !t->checking && !t->corrupt && resumeSize > world->resume.capacity) {
+            world->resume.data = realloc(world->resume.data, resumeSize);
+            world->resume.capacity = resumeSize;
+        }
+        TransferBlock(t, t->checking ? NULL : world->resume.data, resumeSize);
+        if (!t->saving && !t->checking && !t->corrupt) world->resume.size = resumeSize;
+    }
+}
+
+void SaveWorldCheckpoint(const World *world, WorldCheckpoint *checkpoint) {
+    // The header goes in front once the size is known
+    ReserveCheckpoint(checkpoint, sizeof(CheckpointHeader));
+
+    // Saving only reads the world; the walk is shared with restoring, which writes it
+    Transfer t = { .checkpoint = checkpoint, .pos = sizeof(CheckpointHeader), .saving = true };
+    TransferWorld(&t, (World *)world);
+
+    CheckpointHeader header = { CHECKPOINT_MAGIC, CHECKPOINT_VERSION, (unsigned int)t.pos, 0, world->tick };
+    memcpy(checkpoint->data, &header, sizeof(header));
+    checkpoint->size = t.pos;
+}
+
+bool RestoreWorldCheckpoint(World *world, const WorldCheckpoint *checkpoint) {
+    CheckpointHeader header;
+    if (checkpoint->size < sizeof(header)) return false;
+    memcpy(&header, checkpoint->data, sizeof(header));
+    if (header.magic != CHECKPOINT_MAGIC || header.version != CHECKPOINT_VERSION || header.size != checkpoint->size) return false;
+
+    // The check pass reads into a copy, so nothing is written unless every field is usable
+    World shadow = *world;
+    Transfer check = { .source = checkpoint->data, .size = checkpoint->size, .pos = sizeof(header), .checking = true };
+    TransferWorld(&check, &shadow);
+    if (check.corrupt || check.pos != check.size) return false;
+
+    Transfer t = { .source = checkpoint->data, .size = checkpoint->size, .pos = sizeof(header) };
+    TransferWorld(&t, world);
+    return !t.corrupt;
+}
+
+void UnloadWorldCheckpoint(WorldCheckpoint *checkpoint) {
+    free(checkpoint->data);
+    *checkpoint = (WorldCheckpoint){ 0 };
+}
@@ -0,0 +1,230 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "raylib.h"
+#include "spatial.h"
+#include "pool.h"
+#include "jobs.h"
+#include "flowfield.h"
+#include "obstacles.h"
+#include "pattern.h"
+#include "bowling.h"
+#include "rng.h"
+#include <stdbool.h>
+
+#define ENEMY_RESERVE 100     // Initial capacity; storage grows in chunks past these
+#define BULLET_RESERVE 500
+#define HARD_OBSTACLES 4      // Rocks a Hard run places by default
+#define OBSTACLE_CLEARANCE 100.0f   // Free space kept around the player when rocks are placed
+#define ENEMY_RADIUS  20.0f
+#define BULLET_RADIUS 5.0f
+#define MAX_EMITTERS  64
+#define FLOW_CELL_SIZE 20.0f   // Hard-mode navigation grid
+#define REVIVE_CLEAR_RADIUS 150.0f  // A run resumed by the second chance has no enemy this close to the player
+#define REVIVE_ROCK_PASSES  4       // Pushes it takes to step the revived player clear of neighbouring rocks
+#define REVIVE_ROCK_GAP     1.0f    // Least space left between the revived player and any rock
+
+#define CHECKPOINT_MAGIC    0x50434743u    // "CGCP" little-endian
+#define CHECKPOINT_VERSION  2
+
+typedef enum {
+    OPENING_SCENE,
+    GAMEPLAY,
+    MINI_GAME,
+    CLOSING_SCENE
+} GameState;
+
+// Each system draws from its own stream, so how much one draws never shifts another's values
+typedef enum {
+    RANDOM_SPAWN,         // Enemy spawn points
+    RANDOM_OBSTACLES,     // Rock placement
+    RANDOM_ELIXIR,        // Elixir placement
+    RANDOM_BOWLING,       // The lucky strike coin
+    RANDOM_STREAMS
+} RandomSystem;
+
+typedef enum {
+    DIFFICULTY_EASY,
+    DIFFICULTY_MEDIUM,
+    DIFFICULTY_HARD
+} Difficulty;
+
+// Entities are stored as structure-of-arrays so the per-tick kernels stream through
+// contiguous floats instead of striding over whole structs. Each store is a list of
+// arena-allocated chunks of ENTITY_CHUNK_SIZE entities; chunks[c] holds the data for the
+// pool's chunk c, and the pool keeps live entities packed at dense [0, pool.count).
+typedef struct {
+    float x[ENTITY_CHUNK_SIZE];
+    float y[ENTITY_CHUNK_SIZE];
+    float vx[ENTITY_CHUNK_SIZE];
+    float vy[ENTITY_CHUNK_SIZE];
+    float life[ENTITY_CHUNK_SIZE];   // Seconds left; culled at 0 or off the playfield
+} BulletChunk;
+
+typedef struct {
+    float x[ENTITY_CHUNK_SIZE];
+    float y[ENTITY_CHUNK_SIZE];
+    float vx[ENTITY_CHUNK_SIZE];
+    float vy[ENTITY_CHUNK_SIZE];
+    float speed[ENTITY_CHUNK_SIZE];
+} EnemyChunk;
+
+typedef struct {
+    EntityPool pool;
+    BulletChunk **chunks;
+} Bullets;
+
+typedef struct {
+    EntityPool pool;
+    EnemyChunk **chunks;
+} Enemies;
+
+// Field of dense entity i in a chunked store, e.g. ENTITY_AT(&world->enemies, x, i)
+#define ENTITY_AT(store, field, i)  ((store)->chunks[(i) >> ENTITY_CHUNK_SHIFT]->field[(i) & ENTITY_CHUNK_MASK])
+
+// Buttons the simulation understands, sampled once per step by whoever drives it
+typedef enum {
+    INPUT_LEFT    = 1 << 0,
+    INPUT_RIGHT   = 1 << 1,
+    INPUT_UP      = 1 << 2,
+    INPUT_DOWN    = 1 << 3,
+    INPUT_FIRE    = 1 << 4,   // SPACE: shoot in GAMEPLAY, charge/throw in MINI_GAME
+    INPUT_SPECIAL = 1 << 5    // S: use elixir in GAMEPLAY, toggle strike mode in MINI_GAME
+} InputButton;
+
+typedef struct {
+    unsigned int down;       // Buttons held during this step
+    unsigned int pressed;    // Buttons that went down since the previous step
+    unsigned int released;   // Buttons that went up since the previous step
+} WorldInputs;
+
+// One-shot notifications for the presentation layer, cleared at the start of each step
+typedef enum {
+    WORLD_EVENT_PIN_HIT = 1 << 0
+} WorldEvent;
+
+// The whole simulation state as one flat, position-independent blob: a header, the World's
+// fields one after another, then each pool's bookkeeping and the live entities' arrays. Saving
+// and restoring are a run of memcpys into a buffer that grows to fit and is kept.
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} WorldCheckpoint;
+
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int size;          // Whole blob, header included
+    unsigned int reserved;
+    unsigned long long tick;
+} CheckpointHeader;
+
+// Everything GAMEPLAY and MINI_GAME need to advance; no window, audio or GPU required
+typedef struct {
+    GameState  state;
+    Difficulty difficulty;
+
+    float    width;          // Playfield size, set by the driver (window size in the game)
+    float    height;
+    Vector2  playerSize;     // Player sprite size, used for obstacle clearance and hits
+    Vector2  obstacleSize;   // Rock sprite size
+
+    Bullets  bullets;
+    Enemies  enemies;
+    ObstacleMap obstacles;          // Hard: rocks that block the player, bullets and enemies
+    int      hardObstacles;         // Rocks a Hard run places, HARD_OBSTACLES unless a tool wants more
+    Emitter  emitters[MAX_EMITTERS];   // Pattern sources placed by tools; cleared with each run
+    int      emitterCount;
+    const BulletPattern *weapon;    // What FIRE shoots from the player, "shot" by default
+    int      weaponVolleys;
+    Pin      pins[NUM_PINS];
+
+    Vector2  playerPos;
+    float    playerSpeed;
+    int      score;
+    bool     gameOver;
+    bool     secondChanceUsed;
+    float    enemySpawnTimer;
+    RandomStream random[RANDOM_STREAMS];   // Per system, keyed by the world's seed; a checkpoint carries them
+    WorldCheckpoint resume;       // Hard: the world as the latest GAMEPLAY tick began; a strike in the
+                                  // second chance resumes the run from it
+
+    // Elixir buff system
+    bool     elixirAvailable;     // Elixir is on the map
+    Vector2  elixirPos;
+    bool     elixirReady;         // Player has collected elixir
+    float    elixirSpawnTimer;    // Time since last spawn attempt
+    float    elixirDurationTimer; // Time elixir has been on map
+    float    elixirSpawnInterval; // Set by difficulty (5s Medium, 7s Hard)
+
+    // Bowling state
+    BowlingRules bowling;         // Tunables, shared with the throw evaluator
+    Vector2  ballPos;
+    float    t;
+    float    throwAngle;
+    Vector2  ellipseCenter;
+    float    ballSpeed;
+    bool     ballLaunched;
+    float    power;
+    bool     charging;
+    bool     strikeMode;
+    bool     luckyStrike;
+    float    settleTime;            // Frames the pins have had to settle since the ball left the lane
+
+    Arena    arena;                 // Backs every entity chunk; only grows
+    SpatialHash bulletHash;         // Broadphase over live bullet slots at the middle of their paths, rebuilt every GAMEPLAY tick
+    float    bulletReach;           // Longest half-path of any bullet this tick, padding every query of the hash
+    float    tickLength;            // dt of the GAMEPLAY tick in progress: collisions sweep back over it
+    Vector2  playerFrom;            // Where the player stood when the tick began
+    int     *hitCandidates;         // Broadphase query scratch: a row of one entry per bullet slot per job worker
+    int      hitCandidateRows;
+    int     *enemyContacts;         // Per enemy slot: what it touched this tick, found in parallel (see CollideEnemies)
+    FlowField flow;                 // Hard: paths to the player around the obstacles, shared by the whole swarm
+
+    JobSystem *jobs;                // Spreads steering, bullets and collision over threads; NULL runs them inline.
+                                    // Results are the same for any thread count.
+
+    bool     godMode;               // Nothing ends the run; for benchmarks that need a steady swarm
+
+    unsigned int events;          // WorldEvent flags raised by the last step
+    unsigned int lastKnocked;     // Pin mask the last finished throw felled; output only, like events
+    unsigned long long tick;      // Steps taken since InitWorld
+} World;
+
+extern const float ELIXIR_DURATION;
+
+void InitWorld(World *world, float width, float height);   // Seeded with 0 until SeedWorld()
+void SeedWorld(World *world, unsigned long long seed);      // Restarts every random stream from seed
+void UnloadWorld(World *world);
+void StartRun(World *world, Difficulty difficulty);   // Fresh run from the menu or a replay
+void ReturnToMenu(World *world);
+void StepWorld(World *world, WorldInputs inputs, float dt);
+
+// Direct spawns for benchmarks; regular play spawns through StepWorld()
+void SpawnEnemyAt(World *world, Vector2 position);
+void SpawnEnemyBurst(World *world, int count);   // At random points on the playfield's edges, as regular spawns are
+void SpawnBulletAt(World *world, Vector2 position, Vector2 velocity, float life);
+
+// Adds an emitter firing pattern from position around facing (a unit vector), or returns -1
+// when MAX_EMITTERS are placed. AIMED emitters aim at the player.
+int AddEmitter(World *world, const BulletPattern *pattern, Vector2 position, Vector2 facing);
+
+// Hash of everything the simulation carries from one step to the next, for replay checks
+unsigned long long HashWorld(const World *world);
+
+// Saves everything HashWorld() covers and everything stepping depends on, so a restored world
+// steps exactly as the saved one would have. Scratch, caches and the job system stay as they
+// are; the flow field and rock tree rebuild only if the rocks differ.
+void SaveWorldCheckpoint(const World *world, WorldCheckpoint *checkpoint);
+
+// False, leaving the world untouched, when the blob is not a whole checkpoint of this version;
+// the blob is checked end to end before any of the world is written
+bool RestoreWorldCheckpoint(World *world, const WorldCheckpoint *checkpoint);
+void UnloadWorldCheckpoint(WorldCheckpoint *checkpoint);
+
+// Dense index of the live bullet whose path this tick reaches the circle first (lowest slot on
+// ties), or -1
+int FindBulletHit(World *world, Vector2 center, float radius);
+
+#endif // WORLD_H